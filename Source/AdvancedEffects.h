@@ -2,10 +2,24 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <memory>
 
 /**
  * Professional Multi-Mode Distortion with Antialiasing and Gain Compensation
+ *
+ * Processes stereo blocks. The shaper runs inside 2x, 4x or 8x polyphase
+ * half-band oversampling, and Tube, SoftClip and Saturate also use
+ * first-order antiderivative antialiasing (ADAA): each output sample is the
+ * curve's average between consecutive inputs, (F(x1) - F(x0)) / (x1 - x0),
+ * which removes most of the aliasing the oversampling leaves behind. The
+ * mode is switched once per block, not per sample.
+ *
+ * At zero drive or mix the stage is clean and the oversampler is skipped.
+ * The dry signal is always delayed by the oversampler's latency, so
+ * engaging the stage doesn't shift the timing.
  */
 class AdvancedDistortion
 {
@@ -20,163 +34,423 @@ public:
         Saturate
     };
 
-    void prepare(double sampleRate)
+    // 0 = off, 1 = 2x, 2 = 4x, 3 = 8x
+    static constexpr int maxOversamplingStages = 3;
+
+    void prepare(double sampleRate, int maxBlockSize)
     {
         this->sampleRate = sampleRate;
 
+        for (int i = 0; i < maxOversamplingStages; ++i)
+        {
+            oversamplers[(size_t) i] = std::make_unique<juce::dsp::Oversampling<float>>(
+                2, (size_t) (i + 1), juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+            oversamplers[(size_t) i]->initProcessing((size_t) maxBlockSize);
+        }
+
+        dryBuffer.setSize(2, maxBlockSize);
+        buildTubeTable();
+
         // DC blocking filter
-        dcBlocker.setCoefficients(juce::IIRCoefficients::makeHighPass(sampleRate, 10.0));
-        dcBlocker.reset();
+        for (auto& dcBlocker : dcBlockers)
+            dcBlocker.setCoefficients(juce::IIRCoefficients::makeHighPass(sampleRate, 10.0));
 
-        currentDrive = 0.0f;
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& oversampler : oversamplers)
+            if (oversampler != nullptr)
+                oversampler->reset();
+
+        for (auto& dcBlocker : dcBlockers)
+            dcBlocker.reset();
+
+        for (auto& line : dryDelayLines)
+            line.fill(0.0f);
+
+        dryWritePos = 0;
+        lastInputs.fill(0.0);
+        bitcrushLastSamples.fill(0.0f);
+        bitcrushHoldCounters.fill(0);
+        wasEngaged = false;
     }
 
     void setMode(Mode newMode) { mode = newMode; }
 
+    // Expects an already smoothed value (see ParameterSmoothingBank)
     void setDrive(float newDrive)
     {
-        targetDrive = juce::jlimit(0.0f, 1.0f, newDrive);
+        drive = juce::jlimit(0.0f, 1.0f, newDrive);
     }
 
     void setMix(float newMix) { mix = juce::jlimit(0.0f, 1.0f, newMix); }
     void setBias(float newBias) { bias = juce::jlimit(-1.0f, 1.0f, newBias); }
 
-    float processSample(float input)
+    // Changing the factor changes the latency and clears the stage, so call
+    // it while processing is suspended (or from prepareToPlay) and report
+    // getLatencyInSamples() to the host afterwards
+    void setOversampling(int numStages)
     {
-        // Smooth drive parameter changes to avoid zipper noise
-        currentDrive += (targetDrive - currentDrive) * 0.01f;
+        numStages = juce::jlimit(0, maxOversamplingStages, numStages);
 
-        float dry = input;
-        float wet = input;
+        if (numStages == oversamplingStages)
+            return;
 
-        // Input gain staging based on drive
-        float inputGain = 1.0f + currentDrive * 19.0f; // Up to 20x gain
-        wet = wet * inputGain + bias * 0.5f;
+        oversamplingStages = numStages;
+        latency = numStages > 0 ? juce::roundToInt(oversamplers[(size_t) numStages - 1]->getLatencyInSamples()) : 0;
+        jassert(latency < dryDelaySize);
+        reset();
+    }
+
+    int getLatencyInSamples() const { return latency; }
+
+    /**
+     * Distorts both channels in place. numSamples must not exceed the
+     * maxBlockSize given to prepare().
+     */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        jassert(numSamples <= dryBuffer.getNumSamples());
+        float* channels[] = { left, right };
+
+        // Fades the stage in over the first 5% of drive, so leaving zero
+        // doesn't step from the clean signal to the curve
+        const float wetAmount = mix * juce::jmin(1.0f, drive * 20.0f);
+
+        // Without oversampling there is no latency to line up with, so a
+        // bypassed stage leaves the signal untouched
+        if (wetAmount <= 0.0f && latency == 0)
+        {
+            wasEngaged = false;
+            return;
+        }
+
+        // Dry path, delayed to line up with the oversampled wet path
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto& line = dryDelayLines[(size_t) ch];
+            auto* dry = dryBuffer.getWritePointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int pos = (dryWritePos + i) & dryDelayMask;
+                line[(size_t) pos] = channels[ch][i];
+                dry[i] = line[(size_t) ((pos - latency) & dryDelayMask)];
+            }
+        }
+
+        dryWritePos = (dryWritePos + numSamples) & dryDelayMask;
+
+        // Otherwise the bypassed signal keeps the reported latency, so the
+        // host's compensation holds whether or not the stage is engaged
+        if (wetAmount <= 0.0f)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::copy(channels[ch], dryBuffer.getReadPointer(ch), numSamples);
+
+            wasEngaged = false;
+            return;
+        }
+
+        if (!wasEngaged)
+        {
+            // Drop whatever the filters held from the last time it ran
+            if (oversamplingStages > 0)
+                oversamplers[(size_t) oversamplingStages - 1]->reset();
+
+            for (auto& dcBlocker : dcBlockers)
+                dcBlocker.reset();
+
+            lastInputs.fill(0.0);
+            wasEngaged = true;
+        }
+
+        if (oversamplingStages > 0)
+        {
+            auto& oversampler = *oversamplers[(size_t) oversamplingStages - 1];
+            juce::dsp::AudioBlock<float> block(channels, 2, (size_t) numSamples);
+            auto oversampled = oversampler.processSamplesUp(block);
+
+            for (int ch = 0; ch < 2; ++ch)
+                shape(oversampled.getChannelPointer((size_t) ch), (int) oversampled.getNumSamples(), ch);
+
+            oversampler.processSamplesDown(block);
+        }
+        else
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                shape(channels[ch], numSamples, ch);
+        }
+
+        const float makeupGain = getMakeupGain();
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            float* wet = channels[ch];
+            const float* dry = dryBuffer.getReadPointer(ch);
+
+            // DC blocking filter to prevent offset
+            dcBlockers[(size_t) ch].processSamples(wet, numSamples);
+
+            // Apply makeup gain, then mix dry and wet
+            for (int i = 0; i < numSamples; ++i)
+                wet[i] = dry[i] + (wet[i] * makeupGain - dry[i]) * wetAmount;
+        }
+    }
 
-        float makeupGain = 1.0f;
+private:
+    static constexpr int dryDelaySize = 64;
+    static constexpr int dryDelayMask = dryDelaySize - 1;
+
+    // Below this input step ADAA's difference quotient loses precision, so
+    // the curve is evaluated at the midpoint instead
+    static constexpr double adaaTolerance = 1.0e-4;
+
+    // Runs the selected curve over one channel at the current rate
+    void shape(float* data, int numSamples, int channel)
+    {
+        // Input gain staging based on drive
+        const double inputGain = 1.0 + drive * 19.0; // Up to 20x gain
+        const double offset = bias * 0.5;
 
         switch (mode)
         {
             case Mode::Tube:
-            {
                 // Triode tube modeling with plate curves
                 // Based on 12AX7 characteristics
-                wet = tubeSaturation(wet);
-                makeupGain = 1.0f / (1.0f + currentDrive * 0.5f);
+                processAntiderivative(data, numSamples, channel, inputGain, offset,
+                                      [] (double x) { return tubeSaturation(x); },
+                                      [this] (double x) { return tubeAntiderivative(x); });
                 break;
-            }
 
             case Mode::HardClip:
-            {
-                // Soft knee hard clipping (not brick wall)
-                const float knee = 0.1f;
-                if (wet > 1.0f - knee)
-                    wet = 1.0f - knee + knee * std::tanh((wet - (1.0f - knee)) / knee);
-                else if (wet < -(1.0f - knee))
-                    wet = -(1.0f - knee) + knee * std::tanh((wet + (1.0f - knee)) / knee);
-                makeupGain = 0.9f;
+                processCurve(data, numSamples, inputGain, offset, [] (float x)
+                {
+                    // Soft knee hard clipping (not brick wall)
+                    const float knee = 0.1f;
+                    if (x > 1.0f - knee)
+                        return 1.0f - knee + knee * std::tanh((x - (1.0f - knee)) / knee);
+                    if (x < -(1.0f - knee))
+                        return -(1.0f - knee) + knee * std::tanh((x + (1.0f - knee)) / knee);
+                    return x;
+                });
                 break;
-            }
 
             case Mode::SoftClip:
-            {
                 // Cubic soft clipping with gain compensation
-                if (std::abs(wet) > 1.0f)
-                    wet = (wet > 0.0f) ? 1.0f : -1.0f;
-                else
-                    wet = wet - (wet * wet * wet) / 3.0f;
-                makeupGain = 1.2f;
+                processAntiderivative(data, numSamples, channel, inputGain, offset,
+                                      [] (double x) { return std::abs(x) > 1.0 ? (x > 0.0 ? 1.0 : -1.0) : x - x * x * x / 3.0; },
+                                      [] (double x)
+                                      {
+                                          const double x2 = x * x;
+                                          return std::abs(x) > 1.0 ? std::abs(x) - 7.0 / 12.0 : x2 * 0.5 - x2 * x2 / 12.0;
+                                      });
                 break;
-            }
 
             case Mode::Bitcrush:
-            {
-                // Bitcrushing with antialiasing
-                float bits = 16.0f - (currentDrive * 14.0f); // 16 down to 2 bits
-                float levels = std::pow(2.0f, bits);
-
-                // Sample rate reduction with smoothing
-                float sampleRateReduction = 1.0f + currentDrive * 15.0f;
-
-                if (++bitcrushHoldCounter >= static_cast<int>(sampleRateReduction))
-                {
-                    bitcrushLastSample = std::round(wet * levels) / levels;
-                    bitcrushHoldCounter = 0;
-                }
-
-                wet = bitcrushLastSample;
-                makeupGain = 1.0f;
+                bitcrush(data, numSamples, channel, static_cast<float>(inputGain), static_cast<float>(offset));
                 break;
-            }
 
             case Mode::Wavefold:
-            {
-                // Wavefolding algorithm
-                // Apply multiple folds for more aggressive effect
-                float folded = wet;
-                while (folded > 1.0f) folded = 2.0f - folded;
-                while (folded < -1.0f) folded = -2.0f - folded;
-                wet = folded;
-                makeupGain = 0.7f;
+                processCurve(data, numSamples, inputGain, offset, [] (float x)
+                {
+                    // Triangle fold: reflects off +-1 as many times as needed
+                    float phase = (x + 1.0f) * 0.25f;
+                    phase -= std::floor(phase);
+                    return 1.0f - 4.0f * std::abs(phase - 0.5f);
+                });
                 break;
-            }
 
             case Mode::Saturate:
-            {
                 // Arctangent saturation with proper curve
-                wet = (2.0f / juce::MathConstants<float>::pi) * std::atan(wet * 2.5f);
-                makeupGain = 1.1f;
+                processAntiderivative(data, numSamples, channel, inputGain, offset,
+                                      [] (double x) { return (2.0 / juce::MathConstants<double>::pi) * std::atan(x * 2.5); },
+                                      [] (double x)
+                                      {
+                                          return (2.0 / juce::MathConstants<double>::pi)
+                                                 * (x * std::atan(x * 2.5) - std::log1p(6.25 * x * x) / 5.0);
+                                      });
                 break;
-            }
         }
+    }
+
+    template <typename Curve>
+    static void processCurve(float* data, int numSamples, double inputGain, double offset, Curve curve)
+    {
+        const float gain = static_cast<float>(inputGain);
+        const float shift = static_cast<float>(offset);
 
-        // DC blocking filter to prevent offset
-        wet = dcBlocker.processSingleSampleRaw(wet);
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = curve(data[i] * gain + shift);
+    }
 
-        // Apply makeup gain
-        wet *= makeupGain;
+    // First-order ADAA. Works in double, since the antiderivatives grow
+    // with the square of the input.
+    template <typename Curve, typename Antiderivative>
+    void processAntiderivative(float* data, int numSamples, int channel, double inputGain, double offset,
+                               Curve curve, Antiderivative antiderivative)
+    {
+        double x0 = lastInputs[(size_t) channel];
+        double F0 = antiderivative(x0);
 
-        // Mix dry and wet
-        return dry + (wet - dry) * mix;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double x1 = data[i] * inputGain + offset;
+            const double F1 = antiderivative(x1);
+            const double dx = x1 - x0;
+
+            data[i] = static_cast<float>(std::abs(dx) > adaaTolerance ? (F1 - F0) / dx
+                                                                      : curve(0.5 * (x0 + x1)));
+            x0 = x1;
+            F0 = F1;
+        }
+
+        lastInputs[(size_t) channel] = x0;
     }
 
-private:
-    float tubeSaturation(float input)
+    // Bitcrushing; the hold length counts base-rate samples
+    void bitcrush(float* data, int numSamples, int channel, float inputGain, float offset)
     {
-        // 12AX7 triode tube model
-        // Asymmetric clipping characteristic
-        float x = input * 1.5f;
+        const float bits = 16.0f - (drive * 14.0f); // 16 down to 2 bits
+        const float levels = std::pow(2.0f, bits);
+        const int holdLength = static_cast<int>(1.0f + drive * 15.0f) << oversamplingStages;
+
+        auto& lastSample = bitcrushLastSamples[(size_t) channel];
+        auto& counter = bitcrushHoldCounters[(size_t) channel];
 
-        if (x > 0.0f)
+        for (int i = 0; i < numSamples; ++i)
         {
-            // Positive side - soft compression
-            float Ex = std::exp(-x);
-            return x / (1.0f + Ex) / 1.2f;
+            if (++counter >= holdLength)
+            {
+                lastSample = std::round((data[i] * inputGain + offset) * levels) / levels;
+                counter = 0;
+            }
+
+            data[i] = lastSample;
         }
-        else
+    }
+
+    float getMakeupGain() const
+    {
+        switch (mode)
         {
-            // Negative side - harder compression
-            float Ex = std::exp(x);
-            return x / (1.0f + Ex) / 1.1f;
+            case Mode::Tube:     return 1.0f / (1.0f + drive * 0.5f);
+            case Mode::HardClip: return 0.9f;
+            case Mode::SoftClip: return 1.2f;
+            case Mode::Bitcrush: return 1.0f;
+            case Mode::Wavefold: return 0.7f;
+            case Mode::Saturate: return 1.1f;
         }
+
+        return 1.0f;
+    }
+
+    // 12AX7 triode tube model
+    // Asymmetric clipping characteristic
+    static double tubeSaturation(double input)
+    {
+        return tubeCurve(input * 1.5);
+    }
+
+    // Positive side - soft compression, negative side - harder compression
+    static double tubeCurve(double u)
+    {
+        return u > 0.0 ? u / (1.0 + std::exp(-u)) / 1.2
+                       : u / (1.0 + std::exp(u)) / 1.1;
+    }
+
+    // The tube curve's integral has no elementary form, so it is tabulated
+    // in prepare() and read back with cubic Hermite interpolation, using the
+    // curve itself as the exact slope at each node. Beyond the table the
+    // curve is linear to well within float precision.
+    static constexpr int tubeTableSize = 2048;
+    static constexpr double tubeTableRange = 24.0;
+
+    void buildTubeTable()
+    {
+        const double step = 2.0 * tubeTableRange / tubeTableSize;
+        const int centre = tubeTableSize / 2;
+
+        tubeIntegral.assign((size_t) tubeTableSize + 1, 0.0);
+        tubeSlope.assign((size_t) tubeTableSize + 1, 0.0);
+
+        for (int k = 0; k <= tubeTableSize; ++k)
+            tubeSlope[(size_t) k] = tubeCurve(-tubeTableRange + k * step);
+
+        // Simpson's rule outwards from zero
+        auto simpson = [step] (double a) { return step / 6.0 * (tubeCurve(a) + 4.0 * tubeCurve(a + 0.5 * step) + tubeCurve(a + step)); };
+
+        for (int k = centre; k < tubeTableSize; ++k)
+            tubeIntegral[(size_t) k + 1] = tubeIntegral[(size_t) k] + simpson(-tubeTableRange + k * step);
+
+        for (int k = centre; k > 0; --k)
+            tubeIntegral[(size_t) k - 1] = tubeIntegral[(size_t) k] - simpson(-tubeTableRange + (k - 1) * step);
+    }
+
+    double tubeAntiderivative(double x) const
+    {
+        const double u = x * 1.5;
+
+        if (u >= tubeTableRange)
+            return (tubeIntegral.back() + (u * u - tubeTableRange * tubeTableRange) / 2.4) / 1.5;
+
+        if (u <= -tubeTableRange)
+            return (tubeIntegral.front() + (u * u - tubeTableRange * tubeTableRange) / 2.2) / 1.5;
+
+        const double step = 2.0 * tubeTableRange / tubeTableSize;
+        const double position = (u + tubeTableRange) / step;
+        const int k = juce::jmin(static_cast<int>(position), tubeTableSize - 1);
+        const double t = position - k;
+
+        const double p0 = tubeIntegral[(size_t) k];
+        const double p1 = tubeIntegral[(size_t) k + 1];
+        const double m0 = tubeSlope[(size_t) k] * step;
+        const double m1 = tubeSlope[(size_t) k + 1] * step;
+
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        const double integral = (2.0 * t3 - 3.0 * t2 + 1.0) * p0 + (t3 - 2.0 * t2 + t) * m0
+                              + (-2.0 * t3 + 3.0 * t2) * p1 + (t3 - t2) * m1;
+
+        return integral / 1.5;
     }
 
     Mode mode = Mode::Tube;
-    float currentDrive = 0.0f;
-    float targetDrive = 0.0f;
+    float drive = 0.0f;
     float mix = 0.0f;
     float bias = 0.0f;
     double sampleRate = 44100.0;
 
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, maxOversamplingStages> oversamplers;
+    int oversamplingStages = 0;
+    int latency = 0;
+    bool wasEngaged = false;
+
+    juce::AudioBuffer<float> dryBuffer;
+    std::array<std::array<float, dryDelaySize>, 2> dryDelayLines {};
+    int dryWritePos = 0;
+
+    // ADAA keeps each channel's previous shaper input
+    std::array<double, 2> lastInputs {};
+
+    std::vector<double> tubeIntegral;
+    std::vector<double> tubeSlope;
+
     // Bitcrush state (was static - BUG FIXED)
-    float bitcrushLastSample = 0.0f;
-    int bitcrushHoldCounter = 0;
+    std::array<float, 2> bitcrushLastSamples {};
+    std::array<int, 2> bitcrushHoldCounters {};
 
-    juce::IIRFilter dcBlocker;
+    std::array<juce::IIRFilter, 2> dcBlockers;
 };
 
 /**
- * Professional Delay with Butterworth Filter and Fractional Delay
+ * Professional Stereo Delay with Butterworth Filter and Fractional Delay
+ *
+ * Each channel has its own power-of-two delay line, filter and feedback
+ * path. Ping-pong feeds the mono input into the left line and cross-feeds
+ * each line into the other, so echoes alternate between the sides.
  */
 class AdvancedDelay
 {
@@ -184,26 +458,42 @@ public:
     void prepare(double sampleRate, int maxDelayTime = 2000)
     {
         this->sampleRate = sampleRate;
-        int bufferSize = static_cast<int>(sampleRate * maxDelayTime / 1000.0) + 1;
-        delayBuffer.resize(bufferSize, 0.0f);
+        samplesPerMs = static_cast<float>(sampleRate / 1000.0);
+        maxDelaySamples = static_cast<float>(sampleRate * maxDelayTime / 1000.0);
+
+        // Room for the cubic's two neighbours on either side
+        const int bufferSize = juce::nextPowerOfTwo(static_cast<int>(maxDelaySamples) + 4);
+        for (auto& line : delayLines)
+            line.assign((size_t) bufferSize, 0.0f);
+        mask = bufferSize - 1;
         writePos = 0;
 
         // Initialize 2-pole Butterworth low-pass filter
         updateFilter();
+        filtered1 = { 0.0f, 0.0f };
+        filtered2 = { 0.0f, 0.0f };
 
-        // Initialize smooth parameter values
-        currentDelayTime = 500.0f;
-        currentFeedback = 0.3f;
+        delayTimeStep = 0.0f;
+        delayTimeRampSamples = 0;
     }
 
-    void setDelayTime(float timeMs)
+    // Glides linearly to timeMs over the next rampSamples sample frames
+    // (0 = jump). Feed it control-rate values from ParameterSmoothingBank.
+    void setDelayTime(float timeMs, int rampSamples = 0)
     {
         targetDelayTime = juce::jlimit(1.0f, 2000.0f, timeMs);
+        delayTimeRampSamples = juce::jmax(0, rampSamples);
+
+        if (delayTimeRampSamples == 0)
+            currentDelayTime = targetDelayTime;
+        else
+            delayTimeStep = (targetDelayTime - currentDelayTime) / static_cast<float>(delayTimeRampSamples);
     }
 
+    // Expects an already smoothed value
     void setFeedback(float fb)
     {
-        targetFeedback = juce::jlimit(0.0f, 0.95f, fb);
+        feedback = juce::jlimit(0.0f, 0.95f, fb);
     }
 
     void setMix(float m)
@@ -222,57 +512,64 @@ public:
         updateFilter();
     }
 
-    float processSample(float input, int channel)
+    /**
+     * Adds the filtered echoes (times mix) to both channels in place
+     */
+    void processBlock(float* left, float* right, int numSamples)
     {
-        // Smooth parameter changes to prevent clicks
-        currentDelayTime += (targetDelayTime - currentDelayTime) * 0.001f;
-        currentFeedback += (targetFeedback - currentFeedback) * 0.01f;
-
-        // Fractional delay using cubic interpolation
-        float delaySamplesFloat = currentDelayTime * sampleRate / 1000.0f;
-        int delaySamplesInt = static_cast<int>(delaySamplesFloat);
-        float fraction = delaySamplesFloat - delaySamplesInt;
-
-        // Get 4 samples for cubic interpolation
-        int pos0 = (writePos - delaySamplesInt - 1 + delayBuffer.size()) % delayBuffer.size();
-        int pos1 = (writePos - delaySamplesInt + delayBuffer.size()) % delayBuffer.size();
-        int pos2 = (writePos - delaySamplesInt + 1 + delayBuffer.size()) % delayBuffer.size();
-        int pos3 = (writePos - delaySamplesInt + 2 + delayBuffer.size()) % delayBuffer.size();
+        float* lineL = delayLines[0].data();
+        float* lineR = delayLines[1].data();
 
-        float y0 = delayBuffer[pos0];
-        float y1 = delayBuffer[pos1];
-        float y2 = delayBuffer[pos2];
-        float y3 = delayBuffer[pos3];
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (delayTimeRampSamples > 0)
+                currentDelayTime = --delayTimeRampSamples > 0 ? currentDelayTime + delayTimeStep : targetDelayTime;
 
-        // Cubic interpolation (Hermite)
-        float c0 = y1;
-        float c1 = 0.5f * (y2 - y0);
-        float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
-        float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+            // Both channels read the same fractional position
+            const float delaySamples = juce::jlimit(2.0f, maxDelaySamples, currentDelayTime * samplesPerMs);
+            const int delayInt = static_cast<int>(delaySamples);
+            const float fraction = delaySamples - static_cast<float>(delayInt);
 
-        float delayed = ((c3 * fraction + c2) * fraction + c1) * fraction + c0;
+            // Newest to oldest around the read point
+            const int pos0 = (writePos - delayInt + 1) & mask;
+            const int pos1 = (writePos - delayInt) & mask;
+            const int pos2 = (writePos - delayInt - 1) & mask;
+            const int pos3 = (writePos - delayInt - 2) & mask;
 
-        // 2-pole Butterworth filter (better than one-pole)
-        filtered1 = filtered1 + filterCoeff * (delayed - filtered1);
-        filtered2 = filtered2 + filterCoeff * (filtered1 - filtered2);
+            const float delayedL = cubic(lineL[pos0], lineL[pos1], lineL[pos2], lineL[pos3], fraction);
+            const float delayedR = cubic(lineR[pos0], lineR[pos1], lineR[pos2], lineR[pos3], fraction);
 
-        float output = input + filtered2 * mix;
+            // 2-pole Butterworth filter (better than one-pole)
+            filtered1[0] += filterCoeff * (delayedL - filtered1[0]);
+            filtered1[1] += filterCoeff * (delayedR - filtered1[1]);
+            filtered2[0] += filterCoeff * (filtered1[0] - filtered2[0]);
+            filtered2[1] += filterCoeff * (filtered1[1] - filtered2[1]);
 
-        // Feedback with soft limiting to prevent runaway
-        float feedbackSample = filtered2 * currentFeedback;
+            const float feedbackL = limitFeedback(filtered2[0] * feedback);
+            const float feedbackR = limitFeedback(filtered2[1] * feedback);
 
-        // Soft limiter on feedback
-        if (std::abs(feedbackSample) > 0.95f)
-            feedbackSample = 0.95f * std::tanh(feedbackSample / 0.95f);
+            if (pingPong)
+            {
+                lineL[writePos] = 0.5f * (left[i] + right[i]) + feedbackR;
+                lineR[writePos] = feedbackL;
+            }
+            else
+            {
+                lineL[writePos] = left[i] + feedbackL;
+                lineR[writePos] = right[i] + feedbackR;
+            }
 
-        // Ping-pong: alternate channels
-        if (pingPong && channel == 1)
-            feedbackSample *= -1.0f;
+            writePos = (writePos + 1) & mask;
 
-        delayBuffer[writePos] = input + feedbackSample;
-        writePos = (writePos + 1) % delayBuffer.size();
+            left[i] += filtered2[0] * mix;
+            right[i] += filtered2[1] * mix;
+        }
 
-        return output;
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            JUCE_SNAP_TO_ZERO(filtered1[ch]);
+            JUCE_SNAP_TO_ZERO(filtered2[ch]);
+        }
     }
 
 private:
@@ -281,57 +578,115 @@ private:
         filterCoeff = 1.0f - std::exp(-2.0f * juce::MathConstants<float>::pi * filterCutoff / sampleRate);
     }
 
-    std::vector<float> delayBuffer;
+    // Hermite through y1 (at fraction 0) and y2 (at 1)
+    static float cubic(float y0, float y1, float y2, float y3, float fraction)
+    {
+        float c0 = y1;
+        float c1 = 0.5f * (y2 - y0);
+        float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+        float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+
+        return ((c3 * fraction + c2) * fraction + c1) * fraction + c0;
+    }
+
+    // Soft limiting to prevent runaway
+    static float limitFeedback(float sample)
+    {
+        if (std::abs(sample) > 0.95f)
+            return 0.95f * std::tanh(sample / 0.95f);
+
+        return sample;
+    }
+
+    std::array<std::vector<float>, 2> delayLines;
+    int mask = 0;
     int writePos = 0;
     double sampleRate = 44100.0;
+    float samplesPerMs = 44.1f;
+    float maxDelaySamples = 88200.0f;
 
     float targetDelayTime = 500.0f;
     float currentDelayTime = 500.0f;
-    float targetFeedback = 0.3f;
-    float currentFeedback = 0.3f;
+    float delayTimeStep = 0.0f;
+    int delayTimeRampSamples = 0;
+    float feedback = 0.3f;
     float mix = 0.3f;
 
     bool pingPong = false;
     float filterCutoff = 8000.0f;
     float filterCoeff = 0.5f;
 
-    // 2-pole filter state
-    float filtered1 = 0.0f;
-    float filtered2 = 0.0f;
+    // 2-pole filter state, per channel
+    std::array<float, 2> filtered1 { 0.0f, 0.0f };
+    std::array<float, 2> filtered2 { 0.0f, 0.0f };
 };
 
 /**
  * Freeverb-Style Reverb with Early Reflections and Shimmer
+ *
+ * The comb bank runs all its combs side by side as SIMD lanes. Every line
+ * is a power-of-two ring sharing one write position, stored time-major:
+ * row t holds sample t of every comb, so each frame writes one contiguous
+ * row and reads its delayed samples through a mask instead of a modulo.
+ *
+ * In true-stereo mode a second set of combs and allpasses is tuned
+ * stereoSpread samples longer for the right channel, as in the original
+ * Freeverb, and width crossfades between the two.
  */
 class EnhancedReverb
 {
 public:
+    static constexpr int numCombs = 8;
+    static constexpr int numAllpasses = 4;
+    static constexpr int stereoSpread = 23;
+
     void prepare(double sampleRate)
     {
         this->sampleRate = sampleRate;
 
-        // Initialize allpass and comb filters for Freeverb algorithm
+        // Freeverb tunings at 44.1 kHz; lanes numCombs and up are the right channel
         const int combTunings[] = {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617};
         const int allpassTunings[] = {225, 556, 441, 341};
+        const double scale = sampleRate / 44100.0;
 
-        for (int i = 0; i < 8; ++i)
+        for (int i = 0; i < numCombs; ++i)
         {
-            int size = static_cast<int>(combTunings[i] * sampleRate / 44100.0);
-            combBuffers[i].resize(size, 0.0f);
-            combIndices[i] = 0;
-            filterStates[i] = 0.0f;
+            combDelays[i] = static_cast<int>(combTunings[i] * scale);
+            combDelays[i + numCombs] = static_cast<int>((combTunings[i] + stereoSpread) * scale);
         }
 
-        for (int i = 0; i < 4; ++i)
+        for (int i = 0; i < numAllpasses; ++i)
         {
-            int size = static_cast<int>(allpassTunings[i] * sampleRate / 44100.0);
-            allpassBuffers[i].resize(size, 0.0f);
-            allpassIndices[i] = 0;
+            allpassDelays[i] = static_cast<int>(allpassTunings[i] * scale);
+            allpassDelays[i + numAllpasses] = static_cast<int>((allpassTunings[i] + stereoSpread) * scale);
         }
 
+        const int longestComb = *std::max_element(combDelays.begin(), combDelays.end());
+        const int longestAllpass = *std::max_element(allpassDelays.begin(), allpassDelays.end());
+
+        combRows.assign((size_t) juce::nextPowerOfTwo(longestComb + 1), CombRow {});
+        allpassRows.assign((size_t) juce::nextPowerOfTwo(longestAllpass + 1), AllpassRow {});
+        combMask = (int) combRows.size() - 1;
+        allpassMask = (int) allpassRows.size() - 1;
+
+        // The write position wraps with the longer ring; the shorter mask still
+        // divides it
+        writeMask = juce::jmax(combMask, allpassMask);
+
+        reset();
         updateParameters();
     }
 
+    void reset()
+    {
+        std::fill(combRows.begin(), combRows.end(), CombRow {});
+        std::fill(allpassRows.begin(), allpassRows.end(), AllpassRow {});
+        combStates.fill(0.0f);
+        writePos = 0;
+        shimmerCounter = 0;
+        lastShimmerSamples = { 0.0f, 0.0f };
+    }
+
     void setSize(float s)
     {
         size = juce::jlimit(0.0f, 1.0f, s);
@@ -358,70 +713,158 @@ public:
         shimmer = juce::jlimit(0.0f, 1.0f, s);
     }
 
+    // Switching clears the tail, since the right-hand lines sit idle in mono
+    void setTrueStereo(bool enabled)
+    {
+        if (enabled == trueStereo)
+            return;
+
+        trueStereo = enabled;
+        reset();
+    }
+
+    bool isTrueStereo() const { return trueStereo; }
+
     void processStereo(float* left, float* right, int numSamples)
     {
+        const int numChannels = trueStereo ? 2 : 1;
+        const int numLanes = numChannels * numCombs;
+
         for (int i = 0; i < numSamples; ++i)
         {
             float dryL = left[i];
             float dryR = right[i];
 
-            // Mono input for reverb
+            // Mono input for reverb, fed to both channels' combs
             float input = (dryL + dryR) * 0.5f;
 
-            // Process through comb filters
-            float combOut = 0.0f;
-            for (int j = 0; j < 8; ++j)
+            std::array<float, 2> wet;
+            processCombs(input, numLanes, wet);
+
+            for (int ch = 0; ch < numChannels; ++ch)
             {
-                int index = combIndices[j];
-                float delayed = combBuffers[j][index];
+                // Process through allpass filters
+                float allpassOut = wet[(size_t) ch] * 0.125f; // Average of the combs
 
-                // One-pole damping filter
-                filterStates[j] = delayed * (1.0f - damping) + filterStates[j] * damping;
+                for (int j = 0; j < numAllpasses; ++j)
+                {
+                    const int lane = ch * numAllpasses + j;
+                    float delayed = allpassRows[(size_t) ((writePos - allpassDelays[(size_t) lane]) & allpassMask)].lanes[lane];
+                    allpassRows[(size_t) (writePos & allpassMask)].lanes[lane] = allpassOut + delayed * 0.5f;
+                    allpassOut = delayed - allpassOut * 0.5f;
+                }
 
-                combBuffers[j][index] = input + filterStates[j] * roomSize;
-                combIndices[j] = (index + 1) % combBuffers[j].size();
+                // Shimmer effect (pitch shift up one octave)
+                if (shimmer > 0.001f)
+                {
+                    // Simple octave-up using sample skipping (not perfect but musical)
+                    if (shimmerCounter % 2 == 0)
+                        lastShimmerSamples[(size_t) ch] = allpassOut;
 
-                combOut += filterStates[j];
-            }
-            combOut *= 0.125f; // Average
+                    allpassOut += lastShimmerSamples[(size_t) ch] * shimmer * 0.3f;
+                }
 
-            // Process through allpass filters
-            float allpassOut = combOut;
-            for (int j = 0; j < 4; ++j)
-            {
-                int index = allpassIndices[j];
-                float delayed = allpassBuffers[j][index];
-                float temp = allpassOut + delayed * 0.5f;
-                allpassBuffers[j][index] = temp;
-                allpassOut = delayed - allpassOut * 0.5f;
-                allpassIndices[j] = (index + 1) % allpassBuffers[j].size();
+                wet[(size_t) ch] = allpassOut;
             }
 
-            // Shimmer effect (pitch shift up one octave)
-            float shimmerSample = 0.0f;
             if (shimmer > 0.001f)
-            {
-                // Simple octave-up using sample skipping (not perfect but musical)
-                if (shimmerCounter % 2 == 0)
-                    lastShimmerSample = allpassOut;
-
-                shimmerSample = lastShimmerSample * shimmer * 0.3f;
                 shimmerCounter++;
-            }
 
-            allpassOut += shimmerSample;
+            writePos = (writePos + 1) & writeMask;
 
-            // Create stereo width
-            float wetL = allpassOut * (1.0f + width * 0.5f);
-            float wetR = allpassOut * (1.0f - width * 0.5f);
+            float wetL, wetR;
+
+            if (trueStereo)
+            {
+                // Freeverb's width: full width keeps the sides apart, zero sums them
+                const float wet1 = 0.5f * (1.0f + width);
+                const float wet2 = 0.5f * (1.0f - width);
+                wetL = wet[0] * wet1 + wet[1] * wet2;
+                wetR = wet[1] * wet1 + wet[0] * wet2;
+            }
+            else
+            {
+                // Create stereo width
+                wetL = wet[0] * (1.0f + width * 0.5f);
+                wetR = wet[0] * (1.0f - width * 0.5f);
+            }
 
             // Mix dry and wet
             left[i] = dryL * (1.0f - mix) + wetL * mix;
             right[i] = dryR * (1.0f - mix) + wetR * mix;
         }
+
+        for (auto& state : combStates)
+            JUCE_SNAP_TO_ZERO(state);
     }
 
 private:
+    static constexpr int maxCombLanes = 2 * numCombs;
+
+    // One sample of every comb (or allpass) line
+    struct alignas(64) CombRow
+    {
+        float lanes[maxCombLanes];
+    };
+
+    struct alignas(32) AllpassRow
+    {
+        float lanes[2 * numAllpasses];
+    };
+
+    // Runs one frame through the first numLanes combs and returns each
+    // channel's sum
+    void processCombs(float input, int numLanes, std::array<float, 2>& sums)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+            delayed[(size_t) lane] = combRows[(size_t) ((writePos - combDelays[(size_t) lane]) & combMask)].lanes[lane];
+
+        float* row = combRows[(size_t) (writePos & combMask)].lanes;
+        const float feedforward = 1.0f - damping;
+
+       #if JUCE_USE_SIMD
+        using Vec = juce::dsp::SIMDRegister<float>;
+        static_assert (numCombs % Vec::SIMDNumElements == 0, "each channel's combs must fill whole registers");
+
+        const auto x = Vec::expand(input);
+
+        for (int ch = 0; ch * numCombs < numLanes; ++ch)
+        {
+            auto sum = Vec::expand(0.0f);
+
+            for (int lane = ch * numCombs; lane < (ch + 1) * numCombs; lane += (int) Vec::SIMDNumElements)
+            {
+                // One-pole damping filter
+                const auto state = Vec::fromRawArray(delayed.data() + lane) * feedforward
+                                 + Vec::fromRawArray(combStates.data() + lane) * damping;
+
+                state.copyToRawArray(combStates.data() + lane);
+                (x + state * roomSize).copyToRawArray(row + lane);
+                sum += state;
+            }
+
+            sums[(size_t) ch] = sum.sum();
+        }
+       #else
+        for (int ch = 0; ch * numCombs < numLanes; ++ch)
+        {
+            float sum = 0.0f;
+
+            for (int lane = ch * numCombs; lane < (ch + 1) * numCombs; ++lane)
+            {
+                // One-pole damping filter
+                const float state = delayed[(size_t) lane] * feedforward + combStates[(size_t) lane] * damping;
+
+                combStates[(size_t) lane] = state;
+                row[lane] = input + state * roomSize;
+                sum += state;
+            }
+
+            sums[(size_t) ch] = sum;
+        }
+       #endif
+    }
+
     void updateParameters()
     {
         roomSize = size * 0.28f + 0.7f;
@@ -434,23 +877,368 @@ private:
     float mix = 0.3f;
     float shimmer = 0.0f;
     float roomSize = 0.84f;
+    bool trueStereo = false;
+
+    // Freeverb comb filters (8 parallel per channel)
+    std::vector<CombRow> combRows;
+    std::array<int, maxCombLanes> combDelays {};
+    alignas(64) std::array<float, maxCombLanes> combStates {};
+    alignas(64) std::array<float, maxCombLanes> delayed {};
+    int combMask = 0;
 
-    // Freeverb comb filters (8 parallel)
-    std::vector<float> combBuffers[8];
-    int combIndices[8];
-    float filterStates[8];
+    // Allpass filters (4 in series per channel)
+    std::vector<AllpassRow> allpassRows;
+    std::array<int, 2 * numAllpasses> allpassDelays {};
+    int allpassMask = 0;
 
-    // Allpass filters (4 in series)
-    std::vector<float> allpassBuffers[4];
-    int allpassIndices[4];
+    int writePos = 0;
+    int writeMask = 0;
 
     // Shimmer state (was static - BUG FIXED)
     int shimmerCounter = 0;
-    float lastShimmerSample = 0.0f;
+    std::array<float, 2> lastShimmerSamples { 0.0f, 0.0f };
+};
+
+/**
+ * Feedback Delay Network Reverb
+ *
+ * 8 or 16 delay lines fed back through a Householder matrix. Each line has
+ * its own damping one-pole, a decay gain set from its length so every line
+ * dies away at the same rate, and a slowly modulated read position that
+ * keeps the tail from ringing metallic. Even lines feed the left output
+ * and odd lines the right.
+ *
+ * Like EnhancedReverb's comb bank, the lines are power-of-two rings stored
+ * time-major, and the per-line work runs as SIMD lanes. The Householder
+ * reflection (x - 2/N * sum(x)) needs only one horizontal sum, so mixing
+ * costs O(N) instead of O(N^2).
+ */
+class FDNReverb
+{
+public:
+    static constexpr int maxLines = 16;
+
+    void prepare(double sampleRate)
+    {
+        this->sampleRate = sampleRate;
+
+        // Mutually prime lengths at 44.1 kHz; 8-line mode takes every other one
+        const int lineTunings[] = {719, 787, 859, 937, 1019, 1103, 1193, 1289,
+                                   1399, 1511, 1627, 1753, 1889, 2039, 2203, 2371};
+        const double scale = sampleRate / 44100.0;
+
+        for (int i = 0; i < maxLines; ++i)
+            lineTunings16[i] = static_cast<float>(lineTunings[i] * scale);
+
+        modulationDepth = static_cast<float>(0.0004 * sampleRate); // 0.4 ms
+
+        const int longest = static_cast<int>(lineTunings16[maxLines - 1] + modulationDepth) + 2;
+        rows.assign((size_t) juce::nextPowerOfTwo(longest + 1), Row {});
+        mask = (int) rows.size() - 1;
+
+        configureLines();
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(rows.begin(), rows.end(), Row {});
+        dampingStates.fill(0.0f);
+        writePos = 0;
+        shimmerCounter = 0;
+        lastShimmerSamples = { 0.0f, 0.0f };
+
+        // Quadrature LFOs start spread around the circle
+        for (int i = 0; i < maxLines; ++i)
+        {
+            const float angle = juce::MathConstants<float>::twoPi * static_cast<float>(i) / maxLines;
+            lfoCos[i] = std::cos(angle);
+            lfoSin[i] = std::sin(angle);
+            currentDelays[i] = baseDelays[i] + modulationDepth * (0.5f + 0.5f * lfoSin[i]);
+            delayRamps[i] = 0.0f;
+        }
+
+        modulationCountdown = 0;
+    }
+
+    // 8 or 16; switching clears the tail
+    void setNumLines(int newNumLines)
+    {
+        newNumLines = newNumLines > 8 ? 16 : 8;
+
+        if (newNumLines == numLines)
+            return;
+
+        numLines = newNumLines;
+        configureLines();
+        reset();
+    }
+
+    int getNumLines() const { return numLines; }
+
+    void setSize(float s)
+    {
+        s = juce::jlimit(0.0f, 1.0f, s);
+
+        if (s != size)
+        {
+            size = s;
+            updateDecay();
+        }
+    }
+
+    void setDamping(float d)
+    {
+        damping = juce::jlimit(0.0f, 0.95f, d);
+    }
+
+    void setWidth(float w)
+    {
+        width = juce::jlimit(0.0f, 1.0f, w);
+    }
+
+    void setMix(float m)
+    {
+        mix = juce::jlimit(0.0f, 1.0f, m);
+    }
+
+    void setShimmer(float s)
+    {
+        shimmer = juce::jlimit(0.0f, 1.0f, s);
+    }
+
+    void processStereo(float* left, float* right, int numSamples)
+    {
+        const float feedforward = 1.0f - damping;
+        const float reflection = -2.0f / static_cast<float>(numLines);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float dryL = left[i];
+            float dryR = right[i];
+            float input = (dryL + dryR) * 0.5f;
+
+            if (--modulationCountdown <= 0)
+                advanceModulation();
+
+            readLines();
+
+            float* row = rows[(size_t) writePos].lanes;
+            float wetL = 0.0f, wetR = 0.0f;
+
+           #if JUCE_USE_SIMD
+            using Vec = juce::dsp::SIMDRegister<float>;
+            static_assert (8 % Vec::SIMDNumElements == 0, "lines must fill whole registers");
+            constexpr int step = (int) Vec::SIMDNumElements;
+
+            auto sum = Vec::expand(0.0f);
+            auto sumL = Vec::expand(0.0f);
+            auto sumR = Vec::expand(0.0f);
+
+            for (int lane = 0; lane < numLines; lane += step)
+            {
+                // Damping one-pole, then the line's decay
+                const auto state = Vec::fromRawArray(delayed.data() + lane) * feedforward
+                                 + Vec::fromRawArray(dampingStates.data() + lane) * damping;
+                state.copyToRawArray(dampingStates.data() + lane);
+
+                const auto out = state * Vec::fromRawArray(decayGains.data() + lane);
+                out.copyToRawArray(delayed.data() + lane);
+
+                sum += out;
+                sumL += out * Vec::fromRawArray(outputGainsL.data() + lane);
+                sumR += out * Vec::fromRawArray(outputGainsR.data() + lane);
+            }
+
+            const auto correction = Vec::expand(sum.sum() * reflection);
+            const auto x = Vec::expand(input);
+
+            for (int lane = 0; lane < numLines; lane += step)
+            {
+                const auto mixed = Vec::fromRawArray(delayed.data() + lane) + correction;
+                (mixed + x * Vec::fromRawArray(inputGains.data() + lane)).copyToRawArray(row + lane);
+            }
+
+            wetL = sumL.sum();
+            wetR = sumR.sum();
+           #else
+            float sum = 0.0f;
+
+            for (int lane = 0; lane < numLines; ++lane)
+            {
+                // Damping one-pole, then the line's decay
+                const float state = delayed[lane] * feedforward + dampingStates[lane] * damping;
+                dampingStates[lane] = state;
+
+                delayed[lane] = state * decayGains[lane];
+                sum += delayed[lane];
+                wetL += delayed[lane] * outputGainsL[lane];
+                wetR += delayed[lane] * outputGainsR[lane];
+            }
+
+            const float correction = sum * reflection;
+
+            for (int lane = 0; lane < numLines; ++lane)
+                row[lane] = delayed[lane] + correction + input * inputGains[lane];
+           #endif
+
+            writePos = (writePos + 1) & mask;
+
+            // Shimmer effect (pitch shift up one octave), as in EnhancedReverb
+            if (shimmer > 0.001f)
+            {
+                if (shimmerCounter % 2 == 0)
+                    lastShimmerSamples = { wetL, wetR };
+
+                wetL += lastShimmerSamples[0] * shimmer * 0.3f;
+                wetR += lastShimmerSamples[1] * shimmer * 0.3f;
+                shimmerCounter++;
+            }
+
+            // Width narrows the side signal towards mono
+            const float mid = 0.5f * (wetL + wetR);
+            const float side = 0.5f * (wetL - wetR) * width;
+
+            left[i] = dryL * (1.0f - mix) + (mid + side) * mix;
+            right[i] = dryR * (1.0f - mix) + (mid - side) * mix;
+        }
+
+        for (int lane = 0; lane < numLines; ++lane)
+        {
+            JUCE_SNAP_TO_ZERO(dampingStates[lane]);
+
+            // Keep the quadrature LFOs on the unit circle
+            const float norm = 1.5f - 0.5f * (lfoCos[lane] * lfoCos[lane] + lfoSin[lane] * lfoSin[lane]);
+            lfoCos[lane] *= norm;
+            lfoSin[lane] *= norm;
+        }
+    }
+
+private:
+    struct alignas(64) Row
+    {
+        float lanes[maxLines];
+    };
+
+    // Steps the LFOs one modulation tick and sets each line's delay to ramp
+    // linearly to the new position over the tick
+    void advanceModulation()
+    {
+        modulationCountdown = modulationInterval;
+
+        for (int lane = 0; lane < numLines; ++lane)
+        {
+            const float c = lfoCos[lane];
+            const float s = lfoSin[lane];
+            lfoCos[lane] = c * lfoRotCos[lane] - s * lfoRotSin[lane];
+            lfoSin[lane] = s * lfoRotCos[lane] + c * lfoRotSin[lane];
+
+            const float target = baseDelays[lane] + modulationDepth * (0.5f + 0.5f * lfoSin[lane]);
+            delayRamps[lane] = (target - currentDelays[lane]) / static_cast<float>(modulationInterval);
+        }
+    }
+
+    // Reads every line at its modulated, linearly interpolated position
+    void readLines()
+    {
+        for (int lane = 0; lane < numLines; ++lane)
+        {
+            const float delay = currentDelays[lane];
+            currentDelays[lane] += delayRamps[lane];
+
+            const int delayInt = static_cast<int>(delay);
+            const float fraction = delay - static_cast<float>(delayInt);
+
+            const float newer = rows[(size_t) ((writePos - delayInt) & mask)].lanes[lane];
+            const float older = rows[(size_t) ((writePos - delayInt - 1) & mask)].lanes[lane];
+            delayed[lane] = newer + fraction * (older - newer);
+        }
+    }
+
+    void configureLines()
+    {
+        const int stride = maxLines / numLines;
+        const float outputScale = 2.0f / std::sqrt(static_cast<float>(numLines));
+
+        // Sign pattern decorrelates the inputs and the two output sums
+        const float signs[] = {1, -1, 1, 1, -1, 1, -1, -1, 1, 1, -1, -1, -1, 1, 1, -1};
+
+        for (int lane = 0; lane < maxLines; ++lane)
+        {
+            const bool active = lane < numLines;
+
+            baseDelays[lane] = active ? lineTunings16[lane * stride] : 0.0f;
+            inputGains[lane] = active ? signs[lane] : 0.0f;
+            outputGainsL[lane] = active && lane % 2 == 0 ? signs[(lane + 5) % maxLines] * outputScale : 0.0f;
+            outputGainsR[lane] = active && lane % 2 == 1 ? signs[(lane + 5) % maxLines] * outputScale : 0.0f;
+
+            // 0.1 to 0.7 Hz, a different rate per line
+            const float rate = 0.1f + 0.6f * static_cast<float>(lane) / maxLines;
+            const float omega = juce::MathConstants<float>::twoPi * rate * modulationInterval / static_cast<float>(sampleRate);
+            lfoRotCos[lane] = std::cos(omega);
+            lfoRotSin[lane] = std::sin(omega);
+        }
+
+        updateDecay();
+    }
+
+    // Size sets the decay time from 0.5 to 8 seconds; each line's gain gives
+    // -60 dB after that time whatever its length
+    void updateDecay()
+    {
+        const float rt60 = 0.5f * std::pow(16.0f, size);
+
+        for (int lane = 0; lane < maxLines; ++lane)
+        {
+            const float seconds = baseDelays[lane] / static_cast<float>(sampleRate);
+            decayGains[lane] = lane < numLines ? std::pow(10.0f, -3.0f * seconds / rt60) : 0.0f;
+        }
+    }
+
+    double sampleRate = 44100.0;
+    int numLines = 8;
+    float size = 0.5f;
+    float damping = 0.5f;
+    float width = 1.0f;
+    float mix = 0.3f;
+    float shimmer = 0.0f;
+    float modulationDepth = 17.6f;
+
+    std::vector<Row> rows;
+    int mask = 0;
+    int writePos = 0;
+
+    std::array<float, maxLines> lineTunings16 {};
+    std::array<float, maxLines> baseDelays {};
+    alignas(64) std::array<float, maxLines> delayed {};
+    alignas(64) std::array<float, maxLines> dampingStates {};
+    alignas(64) std::array<float, maxLines> decayGains {};
+    alignas(64) std::array<float, maxLines> inputGains {};
+    alignas(64) std::array<float, maxLines> outputGainsL {};
+    alignas(64) std::array<float, maxLines> outputGainsR {};
+
+    // Per-line modulation, as unit vectors rotated once per tick
+    static constexpr int modulationInterval = 32;
+    int modulationCountdown = 0;
+    std::array<float, maxLines> currentDelays {};
+    std::array<float, maxLines> delayRamps {};
+    std::array<float, maxLines> lfoCos {};
+    std::array<float, maxLines> lfoSin {};
+    std::array<float, maxLines> lfoRotCos {};
+    std::array<float, maxLines> lfoRotSin {};
+
+    int shimmerCounter = 0;
+    std::array<float, 2> lastShimmerSamples { 0.0f, 0.0f };
 };
 
 /**
  * Professional Chorus Effect with Multiple Voices and Stereo Width
+ *
+ * Processes whole blocks. The three voices' LFOs are unit phasors rotated
+ * by one shared step per sample, so there's no per-sample sin; pan gains
+ * are recomputed only when the width changes. Each voice is one SIMD lane,
+ * so the LFO update, delay calculation and tap interpolation run across
+ * all three voices at once.
  */
 class ChorusEffect
 {
@@ -460,19 +1248,37 @@ public:
         this->sampleRate = sampleRate;
 
         // 50ms max delay buffer
-        int bufferSize = static_cast<int>(sampleRate * 0.05);
-        delayBuffer.resize(bufferSize, 0.0f);
+        int bufferSize = juce::nextPowerOfTwo(static_cast<int>(sampleRate * 0.05));
+        delayBuffer.assign((size_t) bufferSize, 0.0f);
+        mask = bufferSize - 1;
         writePos = 0;
+        feedbackSample = 0.0f;
+
+        // LFO phases 0, 120 and 240 degrees; the spare lanes stay silent
+        const float phases[] = { 0.0f, juce::MathConstants<float>::pi * 0.66f, juce::MathConstants<float>::pi * 1.33f };
+
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            lfoCos[voice] = std::cos(phases[voice]);
+            lfoSin[voice] = std::sin(phases[voice]);
+
+            // Modulated delay time (5-20ms base), voices staggered
+            baseDelays[voice] = (10.0f + voice * 3.0f) * static_cast<float>(sampleRate) / 1000.0f;
+        }
 
-        // Initialize LFO phases for each voice
-        lfoPhases[0] = 0.0f;
-        lfoPhases[1] = juce::MathConstants<float>::pi * 0.66f;  // 120 degrees
-        lfoPhases[2] = juce::MathConstants<float>::pi * 1.33f;  // 240 degrees
+        updateRotation();
+        updatePanGains();
     }
 
     void setRate(float rateHz)
     {
-        rate = juce::jlimit(0.1f, 10.0f, rateHz);
+        rateHz = juce::jlimit(0.1f, 10.0f, rateHz);
+
+        if (rateHz != rate)
+        {
+            rate = rateHz;
+            updateRotation();
+        }
     }
 
     void setDepth(float d)
@@ -492,65 +1298,148 @@ public:
 
     void setStereoWidth(float width)
     {
-        stereoWidth = juce::jlimit(0.0f, 1.0f, width);
+        width = juce::jlimit(0.0f, 1.0f, width);
+
+        if (width != stereoWidth)
+        {
+            stereoWidth = width;
+            updatePanGains();
+        }
     }
 
-    void processStereo(float& left, float& right)
+    /**
+     * Mixes the chorus into both channels in place
+     */
+    void processBlock(float* left, float* right, int numSamples)
     {
-        // Write input to delay buffer
-        delayBuffer[writePos] = (left + right) * 0.5f + feedbackSample * feedback;
-        writePos = (writePos + 1) % delayBuffer.size();
+        // Delay swing of up to 8ms either side
+        const float depthSamples = depth * 8.0f * static_cast<float>(sampleRate) / 1000.0f;
 
-        // 3-voice chorus for richness
-        float wetL = 0.0f;
-        float wetR = 0.0f;
-
-        for (int voice = 0; voice < 3; ++voice)
+        for (int i = 0; i < numSamples; ++i)
         {
-            // Update LFO
-            float lfoValue = std::sin(lfoPhases[voice]);
-            lfoPhases[voice] += 2.0f * juce::MathConstants<float>::pi * rate / sampleRate;
-            if (lfoPhases[voice] > juce::MathConstants<float>::twoPi)
-                lfoPhases[voice] -= juce::MathConstants<float>::twoPi;
+            // Write input to delay buffer
+            delayBuffer[(size_t) writePos] = (left[i] + right[i]) * 0.5f + feedbackSample * feedback;
+            writePos = (writePos + 1) & mask;
 
-            // Modulated delay time (5-20ms base, modulated by depth)
-            float baseDelay = 10.0f + voice * 3.0f;  // Stagger voices
-            float modDelay = baseDelay + lfoValue * depth * 8.0f;
-            float delaySamples = modDelay * sampleRate / 1000.0f;
+           #if JUCE_USE_SIMD
+            using Vec = juce::dsp::SIMDRegister<float>;
+            static_assert (numLanes % Vec::SIMDNumElements == 0, "voices must fill whole registers");
+            constexpr int step = (int) Vec::SIMDNumElements;
 
-            // Read from delay buffer with linear interpolation
-            int delayInt = static_cast<int>(delaySamples);
-            float delayFrac = delaySamples - delayInt;
+            for (int lane = 0; lane < numLanes; lane += step)
+            {
+                const auto c = Vec::fromRawArray(lfoCos.data() + lane);
+                const auto s = Vec::fromRawArray(lfoSin.data() + lane);
 
-            int readPos1 = (writePos - delayInt + delayBuffer.size()) % delayBuffer.size();
-            int readPos2 = (readPos1 - 1 + delayBuffer.size()) % delayBuffer.size();
+                (Vec::fromRawArray(baseDelays.data() + lane) + s * depthSamples).copyToRawArray(delays.data() + lane);
+                (c * rotationCos - s * rotationSin).copyToRawArray(lfoCos.data() + lane);
+                (s * rotationCos + c * rotationSin).copyToRawArray(lfoSin.data() + lane);
+            }
 
-            float sample1 = delayBuffer[readPos1];
-            float sample2 = delayBuffer[readPos2];
-            float delayedSample = sample1 * (1.0f - delayFrac) + sample2 * delayFrac;
+            gatherTaps();
 
-            // Pan voices across stereo field
-            float pan = (voice - 1.0f) / 2.0f * stereoWidth;  // -1, 0, +1 scaled by width
-            float leftGain = std::cos((pan + 1.0f) * juce::MathConstants<float>::pi / 4.0f);
-            float rightGain = std::sin((pan + 1.0f) * juce::MathConstants<float>::pi / 4.0f);
+            auto sumL = Vec::expand(0.0f);
+            auto sumR = Vec::expand(0.0f);
 
-            wetL += delayedSample * leftGain;
-            wetR += delayedSample * rightGain;
-        }
+            for (int lane = 0; lane < numLanes; lane += step)
+            {
+                // Read from delay buffer with linear interpolation
+                const auto newer = Vec::fromRawArray(newerTaps.data() + lane);
+                const auto older = Vec::fromRawArray(olderTaps.data() + lane);
+                const auto tap = newer + (older - newer) * Vec::fromRawArray(fractions.data() + lane);
 
-        wetL *= 0.333f;  // Average 3 voices
-        wetR *= 0.333f;
+                sumL += tap * Vec::fromRawArray(leftGains.data() + lane);
+                sumR += tap * Vec::fromRawArray(rightGains.data() + lane);
+            }
 
-        // Store feedback sample
-        feedbackSample = (wetL + wetR) * 0.5f;
+            const float wetL = sumL.sum();
+            const float wetR = sumR.sum();
+           #else
+            for (int voice = 0; voice < numVoices; ++voice)
+            {
+                const float c = lfoCos[voice];
+                const float s = lfoSin[voice];
+
+                delays[voice] = baseDelays[voice] + s * depthSamples;
+                lfoCos[voice] = c * rotationCos - s * rotationSin;
+                lfoSin[voice] = s * rotationCos + c * rotationSin;
+            }
 
-        // Mix dry and wet
-        left = left * (1.0f - mix) + wetL * mix;
-        right = right * (1.0f - mix) + wetR * mix;
+            gatherTaps();
+
+            float wetL = 0.0f;
+            float wetR = 0.0f;
+
+            for (int voice = 0; voice < numVoices; ++voice)
+            {
+                // Read from delay buffer with linear interpolation
+                const float tap = newerTaps[voice] + (olderTaps[voice] - newerTaps[voice]) * fractions[voice];
+                wetL += tap * leftGains[voice];
+                wetR += tap * rightGains[voice];
+            }
+           #endif
+
+            // Store feedback sample
+            feedbackSample = (wetL + wetR) * 0.5f;
+
+            // Mix dry and wet
+            left[i] = left[i] * (1.0f - mix) + wetL * mix;
+            right[i] = right[i] * (1.0f - mix) + wetR * mix;
+        }
+
+        // Keep the phasors on the unit circle
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            const float norm = 1.5f - 0.5f * (lfoCos[voice] * lfoCos[voice] + lfoSin[voice] * lfoSin[voice]);
+            lfoCos[voice] *= norm;
+            lfoSin[voice] *= norm;
+        }
+
+        JUCE_SNAP_TO_ZERO(feedbackSample);
     }
 
 private:
+    static constexpr int numVoices = 3;
+
+    // Padded to a whole AVX register (and so to any narrower one) with
+    // zero-gain spare lanes
+    static constexpr int numLanes = 8;
+
+    // Splits each voice's delay into whole samples and a fraction and fetches
+    // the two samples either side
+    void gatherTaps()
+    {
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            const int delayInt = static_cast<int>(delays[voice]);
+            fractions[voice] = delays[voice] - static_cast<float>(delayInt);
+
+            newerTaps[voice] = delayBuffer[(size_t) ((writePos - delayInt) & mask)];
+            olderTaps[voice] = delayBuffer[(size_t) ((writePos - delayInt - 1) & mask)];
+        }
+    }
+
+    void updateRotation()
+    {
+        const double omega = juce::MathConstants<double>::twoPi * rate / sampleRate;
+        rotationCos = static_cast<float>(std::cos(omega));
+        rotationSin = static_cast<float>(std::sin(omega));
+    }
+
+    // Pan voices across stereo field: -1, 0, +1 scaled by width, equal
+    // power, with the 1/3 voice average folded in
+    void updatePanGains()
+    {
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            const float pan = (voice - 1.0f) / 2.0f * stereoWidth;
+            leftGains[voice] = std::cos((pan + 1.0f) * juce::MathConstants<float>::pi / 4.0f) * 0.333f;
+            rightGains[voice] = std::sin((pan + 1.0f) * juce::MathConstants<float>::pi / 4.0f) * 0.333f;
+        }
+    }
+
     std::vector<float> delayBuffer;
+    int mask = 0;
     int writePos = 0;
     double sampleRate = 44100.0;
 
@@ -560,6 +1449,18 @@ private:
     float feedback = 0.2f; // Feedback amount
     float stereoWidth = 1.0f;
 
-    float lfoPhases[3] = {0.0f, 0.0f, 0.0f};
+    // One lane per voice
+    alignas(64) std::array<float, numLanes> lfoCos {};
+    alignas(64) std::array<float, numLanes> lfoSin {};
+    alignas(64) std::array<float, numLanes> baseDelays {};
+    alignas(64) std::array<float, numLanes> delays {};
+    alignas(64) std::array<float, numLanes> fractions {};
+    alignas(64) std::array<float, numLanes> newerTaps {};
+    alignas(64) std::array<float, numLanes> olderTaps {};
+    alignas(64) std::array<float, numLanes> leftGains {};
+    alignas(64) std::array<float, numLanes> rightGains {};
+
+    float rotationCos = 1.0f;
+    float rotationSin = 0.0f;
     float feedbackSample = 0.0f;
 };
@@ -2,6 +2,7 @@
 
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
+#include <array>
 #include <cmath>
 
 /**
@@ -14,6 +15,8 @@
 class BasicOscillator
 {
 public:
+    static constexpr int maxUnison = 4;
+
     enum class WaveType
     {
         Sine,
@@ -39,6 +42,48 @@ public:
         updatePhaseIncrement();
     }
 
+    /**
+     * Glide linearly to freq over the next numSamples
+     * The caller renders exactly numSamples before the next ramp (or
+     * setFrequency), which snaps to the previous target first
+     */
+    void rampFrequency(float freq, int numSamples)
+    {
+        phaseIncrement = targetIncrement;
+        frequency = juce::jlimit(20.0f, 20000.0f, freq);
+        targetIncrement = juce::jlimit(0.0f, 0.5f, frequency / static_cast<float>(sampleRate));
+        incrementStep = (targetIncrement - phaseIncrement) / static_cast<float>(juce::jmax(1, numSamples));
+    }
+
+    /**
+     * Unison stack: up to maxUnison phases spread evenly across
+     * +-detuneCents/2, mixed at equal power
+     */
+    void setUnison(int numVoices, float detuneCents)
+    {
+        numVoices = juce::jlimit(1, maxUnison, numVoices);
+
+        if (numVoices == unisonVoices && detuneCents == unisonDetune)
+            return;
+
+        // Newly enabled lanes start spread around the main phase so the stack
+        // doesn't open with every saw edge lined up
+        for (int lane = unisonVoices; lane < numVoices; ++lane)
+            lanePhases[lane] = std::fmod(phase + 0.618034f * static_cast<float>(lane), 1.0f);
+
+        unisonVoices = numVoices;
+        unisonDetune = detuneCents;
+
+        const float gain = 1.0f / std::sqrt(static_cast<float>(numVoices));
+
+        for (int lane = 0; lane < maxUnison; ++lane)
+        {
+            const float spread = numVoices > 1 ? static_cast<float>(lane) / static_cast<float>(numVoices - 1) - 0.5f : 0.0f;
+            laneRatios[lane] = lane < numVoices ? std::exp2(spread * detuneCents / 1200.0f) : 1.0f;
+            laneGains[lane] = lane < numVoices ? gain : 0.0f;
+        }
+    }
+
     void setPulseWidth(float width)
     {
         pulseWidth = juce::jlimit(0.01f, 0.99f, width);
@@ -54,6 +99,9 @@ public:
     {
         phase = 0.0f;
         lastOutput = 0.0f;
+
+        for (int lane = 1; lane < maxUnison; ++lane)
+            lanePhases[lane] = std::fmod(0.618034f * static_cast<float>(lane), 1.0f);
     }
 
     /**
@@ -131,7 +179,182 @@ public:
         return output;
     }
 
+    /**
+     * Generate a block of samples
+     * The waveform is chosen once per block, so each inner loop is a single
+     * straight-line kernel instead of a switch per sample
+     */
+    void processBlock(float* output, int numSamples)
+    {
+        if (unisonVoices > 1)
+        {
+            processUnisonBlock(output, numSamples);
+            return;
+        }
+
+        switch (waveType)
+        {
+            case WaveType::Sine:
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    output[i] = std::sin(2.0f * juce::MathConstants<float>::pi * phase);
+                    advancePhase();
+                }
+                break;
+
+            case WaveType::Saw:
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    output[i] = 2.0f * phase - 1.0f - polyBLEP(phase, phaseIncrement);
+                    advancePhase();
+                }
+                break;
+
+            case WaveType::Square:
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    float shifted = phase + 0.5f;
+                    if (shifted >= 1.0f)
+                        shifted -= 1.0f;
+
+                    output[i] = ((phase < 0.5f) ? 1.0f : -1.0f)
+                              + polyBLEP(phase, phaseIncrement) - polyBLEP(shifted, phaseIncrement);
+                    advancePhase();
+                }
+                break;
+
+            case WaveType::Triangle:
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    // Same shape as processSample, written as |saw| of a quarter-shifted phase
+                    float shifted = phase + 0.25f;
+                    if (shifted >= 1.0f)
+                        shifted -= 1.0f;
+
+                    output[i] = 1.0f - 4.0f * std::abs(shifted - 0.5f);
+                    advancePhase();
+                }
+                break;
+
+            case WaveType::Pulse:
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    float shifted = phase + (1.0f - pulseWidth);
+                    if (shifted >= 1.0f)
+                        shifted -= 1.0f;
+
+                    output[i] = ((phase < pulseWidth) ? 1.0f : -1.0f)
+                              + polyBLEP(phase, phaseIncrement) - polyBLEP(shifted, phaseIncrement);
+                    advancePhase();
+                }
+                break;
+        }
+
+        if (numSamples > 0)
+            lastOutput = output[numSamples - 1];
+    }
+
 private:
+    void advancePhase()
+    {
+        phase += phaseIncrement;
+        if (phase >= 1.0f)
+            phase -= 1.0f;
+
+        phaseIncrement += incrementStep;
+    }
+
+    /**
+     * Unison path: the stack's phases live in one fixed-width lane array,
+     * so every waveform runs the same short lane loop per sample (unused
+     * lanes carry zero gain)
+     */
+    void processUnisonBlock(float* output, int numSamples)
+    {
+        lanePhases[0] = phase;
+
+        switch (waveType)
+        {
+            case WaveType::Sine:
+                renderLanes(output, numSamples, [](float p, float)
+                {
+                    return std::sin(2.0f * juce::MathConstants<float>::pi * p);
+                });
+                break;
+
+            case WaveType::Saw:
+                renderLanes(output, numSamples, [](float p, float dt)
+                {
+                    return 2.0f * p - 1.0f - polyBLEP(p, dt);
+                });
+                break;
+
+            case WaveType::Square:
+                renderLanes(output, numSamples, [](float p, float dt)
+                {
+                    float shifted = p + 0.5f;
+                    if (shifted >= 1.0f)
+                        shifted -= 1.0f;
+
+                    return ((p < 0.5f) ? 1.0f : -1.0f) + polyBLEP(p, dt) - polyBLEP(shifted, dt);
+                });
+                break;
+
+            case WaveType::Triangle:
+                renderLanes(output, numSamples, [](float p, float)
+                {
+                    float shifted = p + 0.25f;
+                    if (shifted >= 1.0f)
+                        shifted -= 1.0f;
+
+                    return 1.0f - 4.0f * std::abs(shifted - 0.5f);
+                });
+                break;
+
+            case WaveType::Pulse:
+            {
+                const float width = pulseWidth;
+                renderLanes(output, numSamples, [width](float p, float dt)
+                {
+                    float shifted = p + (1.0f - width);
+                    if (shifted >= 1.0f)
+                        shifted -= 1.0f;
+
+                    return ((p < width) ? 1.0f : -1.0f) + polyBLEP(p, dt) - polyBLEP(shifted, dt);
+                });
+                break;
+            }
+        }
+
+        phase = lanePhases[0];
+
+        if (numSamples > 0)
+            lastOutput = output[numSamples - 1];
+    }
+
+    template <typename Shape>
+    void renderLanes(float* output, int numSamples, Shape&& shape)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float sum = 0.0f;
+
+            for (int lane = 0; lane < maxUnison; ++lane)
+            {
+                const float dt = phaseIncrement * laneRatios[lane];
+                const float p = lanePhases[lane];
+
+                sum += laneGains[lane] * shape(p, dt);
+
+                const float next = p + dt;
+                lanePhases[lane] = next >= 1.0f ? next - 1.0f : next;
+            }
+
+            output[i] = sum;
+            phaseIncrement += incrementStep;
+        }
+    }
+
     /**
      * PolyBLEP (Polynomial Bandwidth-Limited Step)
      *
@@ -145,7 +368,7 @@ private:
      * @param dt Phase increment per sample
      * @return Correction value to subtract from naive waveform
      */
-    float polyBLEP(float t, float dt)
+    static float polyBLEP(float t, float dt)
     {
         // Discontinuity at phase = 0 (or very close to 1)
         if (t < dt)
@@ -171,13 +394,25 @@ private:
 
         // Clamp to prevent phase overflow
         phaseIncrement = juce::jlimit(0.0f, 0.5f, phaseIncrement);
+
+        targetIncrement = phaseIncrement;
+        incrementStep = 0.0f;
     }
 
     WaveType waveType = WaveType::Saw;
     float frequency = 440.0f;
     float phase = 0.0f;
     float phaseIncrement = 0.0f;
+    float targetIncrement = 0.0f;
+    float incrementStep = 0.0f;     // Per-sample change while ramping
     float pulseWidth = 0.5f;
     double sampleRate = 44100.0;
     float lastOutput = 0.0f;
+
+    // Unison stack (lane 0 mirrors phase)
+    int unisonVoices = 1;
+    float unisonDetune = 0.0f;
+    alignas(16) std::array<float, maxUnison> lanePhases {};
+    alignas(16) std::array<float, maxUnison> laneRatios { 1.0f, 1.0f, 1.0f, 1.0f };
+    alignas(16) std::array<float, maxUnison> laneGains { 1.0f, 0.0f, 0.0f, 0.0f };
 };
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <cmath>
+
+/**
+ * Stereo TPT State Variable Lowpass with Control-Rate Modulation
+ *
+ * Same topology as juce::dsp::StateVariableTPTFilter (Zavalishin's TPT SVF),
+ * but the tan() prewarp only runs when a new target is set. In between, the
+ * g and R2 coefficients glide linearly towards the target, so a voice can
+ * modulate its cutoff every few samples without paying for the coefficient
+ * math on every sample.
+ */
+class ControlRateFilter
+{
+public:
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+        reset();
+        setTarget(cutoff, resonance, 0);
+    }
+
+    void reset()
+    {
+        s1 = { 0.0f, 0.0f };
+        s2 = { 0.0f, 0.0f };
+    }
+
+    /**
+     * Coefficients for cutoffHz/resonance are reached at the end of the next
+     * numSamples processed (0 = jump straight there)
+     */
+    void setTarget(float cutoffHz, float newResonance, int numSamples)
+    {
+        cutoff = juce::jlimit(20.0f, 0.49f * static_cast<float>(sampleRate), cutoffHz);
+        resonance = juce::jmax(0.01f, newResonance);
+
+        const float targetG = static_cast<float>(std::tan(juce::MathConstants<double>::pi * cutoff / sampleRate));
+        const float targetR2 = 1.0f / resonance;
+
+        if (numSamples <= 0)
+        {
+            g = targetG;
+            R2 = targetR2;
+            gStep = R2Step = 0.0f;
+        }
+        else
+        {
+            gStep = (targetG - g) / static_cast<float>(numSamples);
+            R2Step = (targetR2 - R2) / static_cast<float>(numSamples);
+        }
+    }
+
+    /**
+     * Filters both channels in place, advancing the coefficient ramp
+     */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        float l1 = s1[0], l2 = s2[0];
+        float r1 = s1[1], r2 = s2[1];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float h = 1.0f / (1.0f + R2 * g + g * g);
+            const float damping = g + R2;
+
+            left[i] = tick(left[i], l1, l2, h, damping);
+            right[i] = tick(right[i], r1, r2, h, damping);
+
+            g += gStep;
+            R2 += R2Step;
+        }
+
+        JUCE_SNAP_TO_ZERO(l1);
+        JUCE_SNAP_TO_ZERO(l2);
+        JUCE_SNAP_TO_ZERO(r1);
+        JUCE_SNAP_TO_ZERO(r2);
+
+        s1 = { l1, r1 };
+        s2 = { l2, r2 };
+    }
+
+private:
+    float tick(float x, float& state1, float& state2, float h, float damping) const
+    {
+        const float yHP = h * (x - state1 * damping - state2);
+        const float yBP = yHP * g + state1;
+        state1 = yHP * g + yBP;
+
+        const float yLP = yBP * g + state2;
+        state2 = yBP * g + yLP;
+
+        return yLP;
+    }
+
+    double sampleRate = 44100.0;
+    float cutoff = 1000.0f;
+    float resonance = 1.0f / juce::MathConstants<float>::sqrt2;
+
+    float g = 0.0f, R2 = 0.0f;
+    float gStep = 0.0f, R2Step = 0.0f;
+
+    std::array<float, 2> s1 { 0.0f, 0.0f };
+    std::array<float, 2> s2 { 0.0f, 0.0f };
+};
@@ -85,6 +85,12 @@ public:
     EffectsPanel(juce::AudioProcessorValueTreeState& apvts)
         : parameters(apvts)
     {
+        // Distortion controls
+        setupSlider(distortionDriveSlider, "Drive", 0.0, 1.0);
+        setupSlider(distortionMixSlider, "Mix", 0.0, 1.0);
+        setupComboBox(distortionModeBox, {"Tube", "Hard Clip", "Soft Clip", "Bitcrush", "Wavefold", "Saturate"});
+        setupComboBox(distortionOversamplingBox, {"Off", "2x", "4x", "8x"});
+
         // Delay controls
         setupSlider(delayTimeSlider, "Time", 1.0, 2000.0);
         delayTimeSlider.setTextValueSuffix(" ms");
@@ -116,6 +122,8 @@ public:
         setupSlider(reverbMixSlider, "Mix", 0.0, 1.0);
         setupSlider(reverbShimmerSlider, "Shimmer", 0.0, 1.0);
 
+        setupComboBox(reverbModeBox, {"Classic", "FDN 8", "FDN 16"});
+
         // Reverb bypass LED
         reverbLED.setOn(true); // On by default
         reverbLED.onClick = [this](bool isOn) {
@@ -132,6 +140,15 @@ public:
         setupSlider(chorusWidthSlider, "Stereo", 0.0, 1.0);
 
         // CREATE ATTACHMENTS - Connect UI to parameters
+        distortionDriveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            parameters, "distortionDrive", distortionDriveSlider);
+        distortionMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            parameters, "distortionMix", distortionMixSlider);
+        distortionModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            parameters, "distortionMode", distortionModeBox);
+        distortionOversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            parameters, "distortionOversampling", distortionOversamplingBox);
+
         delayTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
             parameters, "delayTime", delayTimeSlider);
         delayFeedbackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
@@ -155,6 +172,8 @@ public:
             parameters, "reverbMix", reverbMixSlider);
         reverbShimmerAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
             parameters, "reverbShimmer", reverbShimmerSlider);
+        reverbModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            parameters, "reverbMode", reverbModeBox);
 
         chorusRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
             parameters, "chorusRate", chorusRateSlider);
@@ -193,7 +212,13 @@ public:
         bounds.removeFromTop(40);
 
         // FIXED HEIGHT PER SECTION = BIG KNOBS LIKE MACRO KNOBS
-        int sectionHeight = 165;  // Same as macro knob height
+        // Same as macro knob height, shrinking if four sections don't fit
+        int sectionHeight = juce::jmin(165, bounds.getHeight() / 4);
+
+        // Distortion section (ahead of the delay in the chain)
+        auto distortionArea = bounds.removeFromTop(sectionHeight);
+        layoutSection(distortionArea, "DISTORTION",
+            {&distortionDriveSlider, &distortionMixSlider, &distortionModeBox, &distortionOversamplingBox});
 
         // Delay section (FIRST)
         auto delayArea = bounds.removeFromTop(sectionHeight);
@@ -203,7 +228,7 @@ public:
         // Reverb section (SECOND)
         auto reverbArea = bounds.removeFromTop(sectionHeight);
         layoutSection(reverbArea, "REVERB",
-            {&reverbSizeSlider, &reverbDampingSlider, &reverbWidthSlider, &reverbMixSlider, &reverbShimmerSlider});
+            {&reverbSizeSlider, &reverbDampingSlider, &reverbWidthSlider, &reverbMixSlider, &reverbShimmerSlider, &reverbModeBox});
 
         // Chorus section (THIRD - replacing distortion)
         auto chorusArea = bounds.removeFromTop(sectionHeight);
@@ -233,6 +258,16 @@ private:
         addAndMakeVisible(lbl);
         labels.add(lbl);
     }
+
+    void setupComboBox(juce::ComboBox& box, const juce::StringArray& items)
+    {
+        box.addItemList(items, 1);
+        box.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xfffff0ff));
+        box.setColour(juce::ComboBox::textColourId, juce::Colour(0xff6b4f9e));
+        box.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xffd8b5ff));
+        box.setColour(juce::ComboBox::arrowColourId, juce::Colour(0xff6b4f9e));
+        addAndMakeVisible(box);
+    }
     
     void layoutSection(juce::Rectangle<int>& area, const juce::String& title,
                       std::vector<juce::Component*> components)
@@ -296,11 +331,15 @@ private:
 
     juce::AudioProcessorValueTreeState& parameters;
 
+    juce::Slider distortionDriveSlider, distortionMixSlider;
+    juce::ComboBox distortionModeBox, distortionOversamplingBox;
+
     juce::Slider delayTimeSlider, delayFeedbackSlider, delayMixSlider, delayFilterSlider, delayWidthSlider;
     juce::TextButton pingPongButton;
     LEDIndicator delayLED;
 
     juce::Slider reverbSizeSlider, reverbDampingSlider, reverbWidthSlider, reverbMixSlider, reverbShimmerSlider;
+    juce::ComboBox reverbModeBox;
     LEDIndicator reverbLED;
 
     juce::Slider chorusRateSlider, chorusDepthSlider, chorusMixSlider, chorusFeedbackSlider, chorusWidthSlider;
@@ -309,6 +348,11 @@ private:
     juce::OwnedArray<juce::Label> sectionTitles;
 
     // ATTACHMENTS - Connect UI to APVTS
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> distortionDriveAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> distortionMixAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> distortionModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> distortionOversamplingAttachment;
+
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayTimeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayFeedbackAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayMixAttachment;
@@ -321,6 +365,7 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbWidthAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbMixAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbShimmerAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> reverbModeAttachment;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> chorusRateAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> chorusDepthAttachment;
@@ -184,6 +184,25 @@ public:
         particles.push_back(particle);
     }
     
+    // One telemetry event can stand for several grains. The described grain
+    // is drawn as is and the rest, up to maxGrainsPerBurst, scattered around
+    // it by the texture.
+    void spawnGrainBurst(int count, float position, float amplitude, float pitch, float size)
+    {
+        spawnGrain(position, amplitude, pitch, size);
+        
+        auto& random = juce::Random::getSystemRandom();
+        const float spread = 0.05f + texture * 0.2f;
+        
+        for (int i = 1; i < juce::jmin(count, maxGrainsPerBurst); ++i)
+        {
+            const float scatteredPos = juce::jlimit(0.0f, 1.0f, position + (random.nextFloat() - 0.5f) * spread);
+            spawnGrain(scatteredPos, amplitude * (0.6f + 0.4f * random.nextFloat()), pitch, size);
+        }
+    }
+    
+    static constexpr int maxGrainsPerBurst = 16;
+    
     // Batch spawn grains (for high density)
     void spawnGrains(int count, float density, float textureAmount)
     {
@@ -256,17 +275,22 @@ private:
 /**
  * Spectral Analyzer
  * Shows frequency content in real-time
+ *
+ * pushSamples() only copies into a lock-free FIFO, so it is safe to call
+ * from any single producer thread. Windowing, the FFT, smoothing and the
+ * mapping onto a log frequency axis all happen on the component's timer.
  */
 class SpectralAnalyzer : public juce::Component, private juce::Timer
 {
 public:
     SpectralAnalyzer()
+        : fifo(fifoSize)
     {
-        fftOrder = 11;  // 2048 samples
-        fftSize = 1 << fftOrder;
-        
+        fifoBuffer.resize(fifoSize, 0.0f);
+        fftInput.resize(fftSize, 0.0f);
         fftData.resize(fftSize * 2, 0.0f);
         spectrum.resize(fftSize / 2, 0.0f);
+        displayLevels.resize(numDisplayPoints, 0.0f);
         
         window.resize(fftSize);
         for (int i = 0; i < fftSize; ++i)
@@ -276,6 +300,7 @@ public:
         }
         
         forwardFFT = std::make_unique<juce::dsp::FFT>(fftOrder);
+        updateDisplayLevels();
         startTimerHz(30); // 30 FPS for spectrum
     }
     
@@ -292,37 +317,21 @@ public:
         g.setGradientFill(gradient);
         g.fillRoundedRectangle(bounds, 4.0f);
         
-        // Draw spectrum
+        // Draw spectrum (already on a log frequency axis, 0-1 in level)
         juce::Path spectrumPath;
-        bool firstPoint = true;
         
         float width = bounds.getWidth();
         float height = bounds.getHeight();
         
-        for (int i = 1; i < spectrum.size(); ++i)
+        for (int i = 0; i < numValidPoints; ++i)
         {
-            // Logarithmic frequency scale
-            float freq = (sampleRate * i) / fftSize;
-            float logFreq = std::log10(freq / 20.0f) / std::log10(20000.0f / 20.0f);
-            
-            if (logFreq < 0.0f || logFreq > 1.0f)
-                continue;
+            float x = bounds.getX() + (width * i) / (numDisplayPoints - 1);
+            float y = bounds.getBottom() - (displayLevels[i] * height * 0.9f);
             
-            float x = bounds.getX() + (logFreq * width);
-            float magnitude = spectrum[i];
-            float db = 20.0f * std::log10(magnitude + 0.0001f);
-            float normalizedDb = juce::jmap(db, -60.0f, 0.0f, 0.0f, 1.0f);
-            float y = bounds.getBottom() - (normalizedDb * height * 0.9f);
-            
-            if (firstPoint)
-            {
+            if (i == 0)
                 spectrumPath.startNewSubPath(x, y);
-                firstPoint = false;
-            }
             else
-            {
                 spectrumPath.lineTo(x, y);
-            }
         }
         
         // Close path to bottom
@@ -373,53 +382,122 @@ public:
     
     void pushSamples(const float* samples, int numSamples)
     {
-        const juce::ScopedLock lock(pathMutex);
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
         
-        for (int i = 0; i < numSamples; ++i)
-        {
-            if (fftDataIndex >= fftSize)
-            {
-                // Apply window and perform FFT
-                for (int j = 0; j < fftSize; ++j)
-                {
-                    fftData[j] *= window[j];
-                }
-                
-                forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());
-                
-                // Copy to spectrum with smoothing
-                for (int j = 0; j < fftSize / 2; ++j)
-                {
-                    float magnitude = fftData[j] / fftSize;
-                    spectrum[j] = spectrum[j] * 0.8f + magnitude * 0.2f; // Smooth
-                }
-                
-                fftDataIndex = 0;
-            }
-            
-            fftData[fftDataIndex++] = samples[i];
-        }
+        // A full FIFO drops the newest samples rather than waiting
+        if (size1 > 0)
+            std::copy(samples, samples + size1, fifoBuffer.begin() + start1);
+        
+        if (size2 > 0)
+            std::copy(samples + size1, samples + size1 + size2, fifoBuffer.begin() + start2);
+        
+        fifo.finishedWrite(size1 + size2);
     }
     
     void prepare(double sampleRateToUse)
     {
+        if (sampleRateToUse == sampleRate)
+            return;
+        
         sampleRate = sampleRateToUse;
+        updateDisplayLevels();
     }
     
 private:
+    static constexpr int fftOrder = 11;  // 2048 samples
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int fifoSize = fftSize * 4;
+    static constexpr int numDisplayPoints = 256;
+    
     void timerCallback() override
     {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+        
+        bool spectrumChanged = collectSamples(fifoBuffer.data() + start1, size1);
+        spectrumChanged = collectSamples(fifoBuffer.data() + start2, size2) || spectrumChanged;
+        
+        fifo.finishedRead(size1 + size2);
+        
+        if (spectrumChanged)
+            updateDisplayLevels();
+        
         repaint();
     }
     
-    int fftOrder;
-    int fftSize;
+    // Fills the FFT input and analyses every full frame; true if it did
+    bool collectSamples(const float* samples, int numSamples)
+    {
+        bool analysed = false;
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            fftInput[fftInputIndex++] = samples[i];
+            
+            if (fftInputIndex == fftSize)
+            {
+                performFFT();
+                fftInputIndex = 0;
+                analysed = true;
+            }
+        }
+        
+        return analysed;
+    }
+    
+    void performFFT()
+    {
+        // Apply window and perform FFT
+        for (int j = 0; j < fftSize; ++j)
+            fftData[j] = fftInput[j] * window[j];
+        
+        forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());
+        
+        // Copy to spectrum with smoothing
+        for (int j = 0; j < fftSize / 2; ++j)
+        {
+            float magnitude = fftData[j] / fftSize;
+            spectrum[j] = spectrum[j] * 0.8f + magnitude * 0.2f; // Smooth
+        }
+    }
+    
+    // Resamples the spectrum onto numDisplayPoints log-spaced frequencies
+    // from 20 Hz to 20 kHz, as 0-1 over -60..0 dB
+    void updateDisplayLevels()
+    {
+        const float nyquistBin = static_cast<float>(fftSize / 2 - 1);
+        numValidPoints = 0;
+        
+        for (int i = 0; i < numDisplayPoints; ++i)
+        {
+            float freq = 20.0f * std::pow(1000.0f, static_cast<float>(i) / (numDisplayPoints - 1));
+            float bin = freq * fftSize / static_cast<float>(sampleRate);
+            
+            if (bin >= nyquistBin)
+                break;
+            
+            int index = static_cast<int>(bin);
+            float frac = bin - index;
+            float magnitude = spectrum[index] + frac * (spectrum[index + 1] - spectrum[index]);
+            float db = 20.0f * std::log10(magnitude + 0.0001f);
+            
+            displayLevels[i] = juce::jmap(db, -60.0f, 0.0f, 0.0f, 1.0f);
+            numValidPoints = i + 1;
+        }
+    }
+    
+    juce::AbstractFifo fifo;
+    std::vector<float> fifoBuffer;
+    
+    std::vector<float> fftInput;
+    int fftInputIndex = 0;
     std::vector<float> fftData;
     std::vector<float> spectrum;
     std::vector<float> window;
-    int fftDataIndex = 0;
+    std::vector<float> displayLevels;
+    int numValidPoints = 0;
     
     std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    juce::CriticalSection pathMutex;
     double sampleRate = 44100.0;
 };
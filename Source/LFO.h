@@ -85,6 +85,42 @@ public:
     }
     
     float getNextSample()
+    {
+        return getNextValue(1);
+    }
+    
+    /**
+     * Fills output with one value per samplesPerValue samples, the last one
+     * covering whatever is left, and moves the LFO on by numSamples. Control
+     * rate rendering: each value is only evaluated once.
+     */
+    void renderBlock(float* output, int numSamples, int samplesPerValue)
+    {
+        for (int i = 0; numSamples > 0; ++i)
+        {
+            const int step = juce::jmin(samplesPerValue, numSamples);
+            output[i] = getNextValue(step);
+            numSamples -= step;
+        }
+    }
+    
+    /**
+     * Moves the phase on by numSamples without evaluating the waveform, for
+     * when nothing reads the output. Random and Sample & Hold keep their
+     * last value.
+     */
+    void advance(int numSamples)
+    {
+        lastPhase = phase;
+        phase += static_cast<float>(rate / sampleRate) * static_cast<float>(numSamples);
+        phase -= std::floor(phase);
+    }
+    
+    /**
+     * Evaluates the waveform at the current phase, then moves the phase on
+     * by numSamples
+     */
+    float getNextValue(int numSamples)
     {
         float output = 0.0f;
         float adjustedPhase = phase + phaseOffset;
@@ -116,9 +152,17 @@ public:
                 
             case Shape::Random:
             {
-                // Smooth random interpolation
-                float target = (juce::Random::getSystemRandom().nextFloat() * 2.0f) - 1.0f;
-                randomValue += (target - randomValue) * 0.001f;
+                // Smooth random interpolation, 0.001 per sample. Every sample
+                // draws its own target, so the spread doesn't depend on how
+                // many samples one value covers.
+                auto& random = juce::Random::getSystemRandom();
+                
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float target = (random.nextFloat() * 2.0f) - 1.0f;
+                    randomValue += (target - randomValue) * 0.001f;
+                }
+                
                 output = randomValue;
                 break;
             }
@@ -138,10 +182,10 @@ public:
         lastPhase = phase;
         
         // Advance phase
-        float phaseIncrement = rate / sampleRate;
+        float phaseIncrement = static_cast<float>(rate / sampleRate) * static_cast<float>(numSamples);
         phase += phaseIncrement;
         if (phase >= 1.0f)
-            phase -= 1.0f;
+            phase -= std::floor(phase);
         
         // Apply depth
         output *= depth;
@@ -156,9 +200,17 @@ public:
         return output;
     }
     
+    // The periodic shapes are evaluated here at the current phase, so only
+    // the display and telemetry pay for it; Random and Sample & Hold report
+    // the last value they produced
     float getCurrentValue() const
     {
-        return lastOutput;
+        if (shape == Shape::Random || shape == Shape::SampleHold)
+            return lastOutput;
+        
+        float adjustedPhase = phase + phaseOffset;
+        adjustedPhase -= std::floor(adjustedPhase);
+        return getWaveformAtPhase(adjustedPhase);
     }
     
     float getCurrentPhase() const
@@ -295,8 +347,7 @@ public:
         g.drawLine(bounds.getX(), centerY, bounds.getRight(), centerY, 1.0f);
 
         // Draw current phase indicator
-        float currentPhase = lfo.getCurrentPhase();
-        float indicatorX = bounds.getX() + (currentPhase * width);
+        float indicatorX = bounds.getX() + (displayedPhase * width);
 
         g.setColour(juce::Colour(0xffffb3d9)); // Pastel pink
         g.fillEllipse(indicatorX - 4.0f, centerY - 4.0f, 8.0f, 8.0f);
@@ -327,6 +378,12 @@ public:
         // (Rate can be shown in parameter labels instead)
     }
     
+    // Phase as last reported by the audio thread; the LFO itself runs there
+    void setDisplayedPhase(float phase)
+    {
+        displayedPhase = phase;
+    }
+    
 private:
     void timerCallback() override
     {
@@ -334,5 +391,6 @@ private:
     }
     
     LFO& lfo;
+    float displayedPhase = 0.0f;
 };
 
@@ -153,6 +153,11 @@ public:
         bipolarButton.setBounds(buttonArea.removeFromLeft(buttonWidth).reduced(5));
     }
     
+    void setDisplayedPhase(float phase)
+    {
+        lfoDisplay->setDisplayedPhase(phase);
+    }
+    
 private:
     void updateLFOShape()
     {
@@ -242,13 +247,24 @@ public:
         addAndMakeVisible(lfo1Panel.get());
         addAndMakeVisible(lfo2Panel.get());
         addAndMakeVisible(lfo3Panel.get());
+        
+        controlValues.clear();
     }
     
-    void prepare(double sampleRate)
+    static constexpr int numLFOs = 3;
+    
+    // Samples per rendered LFO value
+    static constexpr int controlInterval = 32;
+    
+    // Allocates the control buffers; call before processing
+    void prepare(double sampleRate, int maxBlockSize)
     {
         lfo1->prepare(sampleRate);
         lfo2->prepare(sampleRate);
         lfo3->prepare(sampleRate);
+        
+        controlValues.setSize(numLFOs, juce::jmax(1, (maxBlockSize + controlInterval - 1) / controlInterval));
+        controlValues.clear();
     }
     
     void reset()
@@ -258,17 +274,38 @@ public:
         lfo3->reset();
     }
     
-    void processBlock(int numSamples)
+    /**
+     * Renders the next numSamples of each LFO flagged in isUsed into its
+     * control buffer, one value per controlInterval samples. The others only
+     * move their phase on, so they're still in time once they're routed.
+     * A block longer than prepared holds its last value to the end.
+     */
+    void processBlock(int numSamples, const std::array<bool, numLFOs>& isUsed)
     {
-        // Generate LFO samples
-        for (int i = 0; i < numSamples; ++i)
+        const int numRendered = juce::jmin(numSamples, controlValues.getNumSamples() * controlInterval);
+        
+        for (int i = 0; i < numLFOs; ++i)
         {
-            lfo1->getNextSample();
-            lfo2->getNextSample();
-            lfo3->getNextSample();
+            auto* lfo = getLFO(i);
+            
+            if (isUsed[(size_t) i])
+            {
+                lfo->renderBlock(controlValues.getWritePointer(i), numRendered, controlInterval);
+                lfo->advance(numSamples - numRendered);
+            }
+            else
+            {
+                lfo->advance(numSamples);
+            }
         }
     }
     
+    // An LFO's value at a sample of the last block, if it was rendered
+    float getValue(int index, int sample) const
+    {
+        return controlValues.getSample(index, juce::jmin(sample / controlInterval, controlValues.getNumSamples() - 1));
+    }
+    
     LFO* getLFO(int index)
     {
         switch (index)
@@ -280,6 +317,18 @@ public:
         }
     }
     
+    // Moves a display's phase marker; call from the message thread
+    void setDisplayedPhase(int index, float phase)
+    {
+        switch (index)
+        {
+            case 0: lfo1Panel->setDisplayedPhase(phase); break;
+            case 1: lfo2Panel->setDisplayedPhase(phase); break;
+            case 2: lfo3Panel->setDisplayedPhase(phase); break;
+            default: break;
+        }
+    }
+    
     void paint(juce::Graphics& g) override
     {
         // Pastel purple background gradient to match main UI
@@ -312,4 +361,7 @@ private:
     
     std::unique_ptr<LFO> lfo1, lfo2, lfo3;
     std::unique_ptr<LFOPanel> lfo1Panel, lfo2Panel, lfo3Panel;
+    
+    // One row of control-rate values per LFO
+    juce::AudioBuffer<float> controlValues { numLFOs, 1 };
 };
@@ -98,17 +98,15 @@ struct ModulationConnection
     ModulationDestination::Type destination;
     float amount = 0.5f;  // -1 to 1
     bool enabled = true;
-    juce::Colour connectionColor;
     
     ModulationConnection(ModulationSource::Type src, 
                         ModulationDestination::Type dest,
                         float amt = 0.5f)
         : source(src), destination(dest), amount(amt)
     {
-        // Color based on source
-        connectionColor = getSourceColor(src);
     }
     
+    // Color based on source
     static juce::Colour getSourceColor(ModulationSource::Type src)
     {
         switch (src)
@@ -128,9 +126,179 @@ struct ModulationConnection
     }
 };
 
+/**
+ * Compiled Modulation Routing
+ *
+ * The connection list flattened for evaluation. Only sources with at least
+ * one enabled connection get a row, and each row holds that source's amount
+ * for every destination, zero where it isn't routed. Evaluating adds each
+ * row, scaled by its source's value, into the destination sums, vectorised
+ * across destinations, so the cost depends on how many sources are in use
+ * and never on how many connections there are.
+ *
+ * Built with compile() whenever the routing changes, never on the audio
+ * thread, and immutable once published (see AdvancedModulationMatrix).
+ */
+struct CompiledModulationRouting
+{
+    static constexpr int numSources = static_cast<int>(ModulationSource::Type::Random) + 1;
+    static constexpr int numDestinations = static_cast<int>(ModulationDestination::Type::Pan) + 1;
+
+    static CompiledModulationRouting compile(const std::vector<ModulationConnection>& connections)
+    {
+        CompiledModulationRouting routing;
+        std::array<int, numSources> rowForSource;
+        rowForSource.fill(-1);
+
+        for (const auto& conn : connections)
+        {
+            if (!conn.enabled)
+                continue;
+
+            const int source = static_cast<int>(conn.source);
+            const int destination = static_cast<int>(conn.destination);
+
+            if (rowForSource[(size_t) source] < 0)
+            {
+                rowForSource[(size_t) source] = routing.numActiveSources;
+                routing.activeSources[(size_t) routing.numActiveSources++] = source;
+            }
+
+            routing.rows[(size_t) rowForSource[(size_t) source]][(size_t) destination] += conn.amount;
+            routing.routed[(size_t) destination] = true;
+        }
+
+        return routing;
+    }
+
+    /**
+     * Writes the summed modulation of every destination into sums, given
+     * one value per source
+     */
+    void evaluate(const float* sourceValues, float* sums) const
+    {
+        juce::FloatVectorOperations::clear(sums, numDestinations);
+
+        for (int row = 0; row < numActiveSources; ++row)
+            juce::FloatVectorOperations::addWithMultiply(sums, rows[(size_t) row].data(),
+                                                         sourceValues[activeSources[(size_t) row]], numDestinations);
+    }
+
+    bool isRouted(ModulationDestination::Type destination) const { return routed[(size_t) destination]; }
+
+    bool usesSource(ModulationSource::Type source) const
+    {
+        for (int row = 0; row < numActiveSources; ++row)
+            if (activeSources[(size_t) row] == static_cast<int>(source))
+                return true;
+
+        return false;
+    }
+
+    // Increases with every publish, so the audio thread can report which
+    // routing it has moved on to
+    juce::uint64 generation = 0;
+
+    int numActiveSources = 0;
+    std::array<int, numSources> activeSources {};
+    std::array<std::array<float, numDestinations>, numSources> rows {};
+    std::array<bool, numDestinations> routed {};
+};
+
+/**
+ * Voice Modulation Bank
+ *
+ * Polyphonic modulation state, stored as structure-of-arrays: one row per
+ * source and one per destination, with a lane per voice. Each voice writes
+ * its own sources (envelopes, velocity, aftertouch, per-note random) into
+ * its lane. Sources every voice shares (LFOs, mod wheel, pitch bend) are
+ * written across the whole row.
+ *
+ * evaluate() applies a compiled routing to every lane at once, with one
+ * vectorised multiply-add per routed source and destination, so 8 voices
+ * or 64 cost the same number of passes. A voice only touches its own lane,
+ * so voices rendering in parallel share nothing; evaluate() runs on the
+ * audio thread between renders.
+ */
+class VoiceModulationBank
+{
+public:
+    static constexpr int maxVoices = 64;
+    static constexpr int numSources = CompiledModulationRouting::numSources;
+    static constexpr int numDestinations = CompiledModulationRouting::numDestinations;
+
+    static bool isGlobalSource(ModulationSource::Type source)
+    {
+        return source == ModulationSource::Type::LFO1 || source == ModulationSource::Type::LFO2
+            || source == ModulationSource::Type::LFO3 || source == ModulationSource::Type::ModWheel
+            || source == ModulationSource::Type::PitchBend;
+    }
+
+    // Sets a shared source for every voice
+    void setGlobalSource(ModulationSource::Type source, float value)
+    {
+        jassert(isGlobalSource(source));
+        juce::FloatVectorOperations::fill(sourceRows[(size_t) source].data(), value, maxVoices);
+    }
+
+    void setVoiceSource(int voice, ModulationSource::Type source, float value)
+    {
+        jassert(voice >= 0 && voice < maxVoices && ! isGlobalSource(source));
+        sourceRows[(size_t) source][(size_t) voice] = value;
+    }
+
+    /**
+     * Sums the modulation of every destination for the first numVoices
+     * lanes
+     */
+    void evaluate(const CompiledModulationRouting& routing, int numVoices)
+    {
+        // Whole SIMD registers; lanes past numVoices are never read
+        const int numLanes = juce::jmin(maxVoices, (numVoices + 3) & ~3);
+
+        for (int destination = 0; destination < numDestinations; ++destination)
+            juce::FloatVectorOperations::clear(destinationRows[(size_t) destination].data(), numLanes);
+
+        for (int row = 0; row < routing.numActiveSources; ++row)
+        {
+            const auto* sourceValues = sourceRows[(size_t) routing.activeSources[(size_t) row]].data();
+            const auto& amounts = routing.rows[(size_t) row];
+
+            for (int destination = 0; destination < numDestinations; ++destination)
+            {
+                if (amounts[(size_t) destination] != 0.0f)
+                    juce::FloatVectorOperations::addWithMultiply(destinationRows[(size_t) destination].data(), sourceValues,
+                                                                 amounts[(size_t) destination], numLanes);
+            }
+        }
+
+        routed = routing.routed;
+    }
+
+    // Summed modulation of a voice's destination, as of the last evaluate()
+    float getModulation(int voice, ModulationDestination::Type destination) const
+    {
+        return destinationRows[(size_t) destination][(size_t) voice];
+    }
+
+    bool isRouted(ModulationDestination::Type destination) const { return routed[(size_t) destination]; }
+
+private:
+    alignas(16) std::array<std::array<float, maxVoices>, numSources> sourceRows {};
+    alignas(16) std::array<std::array<float, maxVoices>, numDestinations> destinationRows {};
+    std::array<bool, numDestinations> routed {};
+};
+
 /**
  * Advanced Modulation Matrix Engine
  * Manages all modulation routings and calculations
+ *
+ * The connection list belongs to the message thread. Every edit compiles a
+ * new immutable routing and publishes it with an atomic pointer swap, so
+ * the audio thread never sees a half-edited routing and never waits. Each
+ * control tick the audio thread picks up the latest routing and
+ * acknowledges its generation. A replaced routing is freed on the message
+ * thread, at a later edit, once a newer generation has been acknowledged.
  */
 class AdvancedModulationMatrix
 {
@@ -139,6 +307,7 @@ public:
     {
         setupSources();
         setupDestinations();
+        compileRouting();
     }
     
     // Add a new modulation connection
@@ -153,12 +322,14 @@ public:
             {
                 conn.amount = amount;
                 conn.enabled = true;
+                compileRouting();
                 return;
             }
         }
         
         // Add new connection
         connections.emplace_back(source, destination, amount);
+        compileRouting();
     }
     
     // Remove a connection
@@ -172,6 +343,7 @@ public:
                 }),
             connections.end()
         );
+        compileRouting();
     }
     
     // Set source value (called from audio processor)
@@ -180,22 +352,40 @@ public:
         sourceValues[static_cast<int>(source)] = value;
     }
     
-    // Get modulated value for a destination
-    float getModulatedValue(ModulationDestination::Type destination, float baseValue)
+    // Audio thread: the routing to use for this control tick. Stays valid
+    // until the next call.
+    const CompiledModulationRouting& acquireRouting()
+    {
+        const auto* routing = publishedRouting.load(std::memory_order_acquire);
+        acknowledgedGeneration.store(routing->generation, std::memory_order_release);
+        return *routing;
+    }
+    
+    // Sums the modulation of every destination at once, with a routing from
+    // acquireRouting(). Call once per control tick, after setting the source
+    // values (audio thread).
+    void evaluate(const CompiledModulationRouting& routing)
+    {
+        routing.evaluate(sourceValues.data(), modulationSums.data());
+    }
+    
+    // Summed modulation of a destination, as of the last evaluate()
+    float getModulation(ModulationDestination::Type destination) const
+    {
+        return modulationSums[static_cast<size_t>(destination)];
+    }
+    
+    // Get modulated value for a destination, as of the last evaluate()
+    float getModulatedValue(ModulationDestination::Type destination, float baseValue) const
     {
-        float modulationSum = 0.0f;
-        
-        for (const auto& conn : connections)
-        {
-            if (conn.destination == destination && conn.enabled)
-            {
-                float sourceValue = sourceValues[static_cast<int>(conn.source)];
-                modulationSum += sourceValue * conn.amount;
-            }
-        }
-        
         // Apply modulation to base value
-        return baseValue + (modulationSum * baseValue); // Multiplicative
+        return baseValue + (getModulation(destination) * baseValue); // Multiplicative
+    }
+    
+    // Message thread: the most recently published routing
+    const CompiledModulationRouting& getCompiledRouting() const
+    {
+        return *latestRouting;
     }
     
     // Get all connections
@@ -244,9 +434,35 @@ public:
     void clearAllConnections()
     {
         connections.clear();
+        compileRouting();
     }
     
 private:
+    void compileRouting()
+    {
+        auto routing = std::make_unique<CompiledModulationRouting>(CompiledModulationRouting::compile(connections));
+        routing->generation = ++lastGeneration;
+
+        publishedRouting.store(routing.get(), std::memory_order_release);
+
+        if (latestRouting != nullptr)
+            retiredRoutings.push_back(std::move(latestRouting));
+
+        latestRouting = std::move(routing);
+        reclaimRetiredRoutings();
+    }
+
+    // Frees the routings the audio thread can no longer be reading: any
+    // older than the generation it last acknowledged
+    void reclaimRetiredRoutings()
+    {
+        const auto acknowledged = acknowledgedGeneration.load(std::memory_order_acquire);
+
+        retiredRoutings.erase(std::remove_if(retiredRoutings.begin(), retiredRoutings.end(),
+                                             [acknowledged] (const auto& routing) { return routing->generation < acknowledged; }),
+                              retiredRoutings.end());
+    }
+    
     void setupSources()
     {
         sources = {
@@ -309,5 +525,15 @@ private:
     std::vector<ModulationSource> sources;
     std::vector<ModulationDestination> destinations;
     std::vector<ModulationConnection> connections;
-    std::array<float, 10> sourceValues = { 0.0f }; // Store current values
+
+    // Routing publication (see class description)
+    std::unique_ptr<CompiledModulationRouting> latestRouting;
+    std::vector<std::unique_ptr<CompiledModulationRouting>> retiredRoutings;
+    std::atomic<CompiledModulationRouting*> publishedRouting { nullptr };
+    std::atomic<juce::uint64> acknowledgedGeneration { 0 };
+    juce::uint64 lastGeneration = 0;
+
+    // Audio thread only
+    std::array<float, CompiledModulationRouting::numSources> sourceValues = { 0.0f }; // Store current values
+    std::array<float, CompiledModulationRouting::numDestinations> modulationSums = { 0.0f };
 };
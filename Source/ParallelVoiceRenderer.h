@@ -0,0 +1,229 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+/**
+ * Parallel Voice Renderer
+ *
+ * A fixed pool of real-time worker threads that run a batch of independent
+ * jobs (one per voice) alongside the audio thread. Nothing on the audio path
+ * allocates or takes a lock:
+ *
+ *  - A batch is published as one 64-bit atomic word (batch id, job count,
+ *    next job index). Workers and the audio thread claim jobs with a CAS on
+ *    that word, so a late worker can never pick up a stale job.
+ *  - Idle workers spin briefly, then sleep on their thread event. The audio
+ *    thread only signals workers that have actually gone to sleep.
+ *  - The audio thread works through the batch too, then spins until the
+ *    last job has finished.
+ *
+ * start() and stop() create and join the threads, so call them from the
+ * message thread while processing is suspended.
+ */
+class ParallelVoiceRenderer
+{
+public:
+    using JobFunction = void (*)(void* context, int jobIndex);
+
+    static constexpr int maxJobs = 0xffff;
+
+    ParallelVoiceRenderer() = default;
+
+    ~ParallelVoiceRenderer()
+    {
+        stop();
+    }
+
+    /**
+     * Starts numWorkers threads pinned to cores 1..numWorkers (core 0 is left
+     * to the host), with real-time scheduling sized for the given block.
+     */
+    void start(int numWorkers, int blockSize, double sampleRate)
+    {
+        stop();
+
+        const int numCpus = juce::jmax(1, juce::SystemStats::getNumCpus());
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            auto worker = std::make_unique<Worker>(*this, i);
+            worker->setAffinityMask(juce::uint32(1) << ((i + 1) % juce::jmin(numCpus, 32)));
+            worker->startRealtimeThread(juce::Thread::RealtimeOptions()
+                                            .withPriority(8)
+                                            .withApproximateAudioProcessingTime(blockSize, sampleRate));
+            workers.push_back(std::move(worker));
+        }
+    }
+
+    void stop()
+    {
+        for (auto& worker : workers)
+        {
+            worker->signalThreadShouldExit();
+            worker->notify();
+        }
+
+        for (auto& worker : workers)
+            worker->stopThread(1000);
+
+        workers.clear();
+    }
+
+    int getNumWorkers() const { return (int) workers.size(); }
+
+    /**
+     * Runs job(context, i) for every i in [0, numJobs) across the pool and the
+     * calling thread, and returns once all of them have finished
+     */
+    void run(int numJobs, JobFunction job, void* context)
+    {
+        jassert(numJobs <= maxJobs);
+
+        if (workers.empty() || numJobs <= 1)
+        {
+            for (int i = 0; i < numJobs; ++i)
+                job(context, i);
+
+            return;
+        }
+
+        jobFunction = job;
+        jobContext = context;
+        pendingJobs.store(numJobs, std::memory_order_relaxed);
+
+        ++batchId;
+        batch.store(makeBatch(batchId, numJobs, 0), std::memory_order_seq_cst);
+
+        for (auto& worker : workers)
+            if (worker->sleeping.load(std::memory_order_seq_cst))
+                worker->notify();
+
+        runJobs();
+
+        while (pendingJobs.load(std::memory_order_acquire) > 0)
+            spinPause();
+    }
+
+private:
+    //==========================================================================
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(ParallelVoiceRenderer& ownerToUse, int index)
+            : juce::Thread("Voice Renderer " + juce::String(index + 1)),
+              owner(ownerToUse)
+        {
+        }
+
+        void run() override
+        {
+            // Voice tails must not go denormal on the workers either
+            juce::ScopedNoDenormals noDenormals;
+
+            auto lastBatch = getBatchId(owner.batch.load(std::memory_order_acquire));
+
+            while (! threadShouldExit())
+            {
+                if (getBatchId(owner.batch.load(std::memory_order_acquire)) == lastBatch)
+                {
+                    waitForBatch(lastBatch);
+                    continue;
+                }
+
+                lastBatch = getBatchId(owner.batch.load(std::memory_order_acquire));
+                owner.runJobs();
+            }
+        }
+
+        std::atomic<bool> sleeping { false };
+
+    private:
+        static constexpr int spinIterations = 2000;
+
+        void waitForBatch(juce::uint64 lastBatch)
+        {
+            for (int i = 0; i < spinIterations; ++i)
+            {
+                if (getBatchId(owner.batch.load(std::memory_order_acquire)) != lastBatch || threadShouldExit())
+                    return;
+
+                spinPause();
+            }
+
+            // Announce the sleep before re-checking, so a batch posted in
+            // between is guaranteed to signal us
+            sleeping.store(true, std::memory_order_seq_cst);
+
+            if (getBatchId(owner.batch.load(std::memory_order_seq_cst)) == lastBatch)
+                wait(10);
+
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+
+        ParallelVoiceRenderer& owner;
+    };
+
+    //==========================================================================
+    // batch word: [63..48] batch id, [47..32] job count, [31..0] next job
+    static juce::uint64 makeBatch(juce::uint64 id, int count, int next)
+    {
+        return ((id & 0xffff) << 48) | ((juce::uint64) count << 32) | (juce::uint64) (juce::uint32) next;
+    }
+
+    static juce::uint64 getBatchId(juce::uint64 word) { return word >> 48; }
+    static int getJobCount(juce::uint64 word) { return (int) ((word >> 32) & 0xffff); }
+    static int getNextJob(juce::uint64 word) { return (int) (word & 0xffffffff); }
+
+    static void spinPause()
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #else
+        std::this_thread::yield();
+       #endif
+    }
+
+    // Claims and runs jobs until the current batch is exhausted
+    void runJobs()
+    {
+        for (;;)
+        {
+            auto word = batch.load(std::memory_order_acquire);
+            int index = 0;
+
+            for (;;)
+            {
+                index = getNextJob(word);
+
+                if (index >= getJobCount(word))
+                    return;
+
+                if (batch.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                    break;
+            }
+
+            // Safe to read: the batch can't be replaced while this job is pending
+            jobFunction(jobContext, index);
+            pendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<juce::uint64> batch { 0 };
+    std::atomic<int> pendingJobs { 0 };
+    juce::uint64 batchId = 0;
+    JobFunction jobFunction = nullptr;
+    void* jobContext = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(ParallelVoiceRenderer)
+};
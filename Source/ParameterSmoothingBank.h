@@ -0,0 +1,131 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+
+/**
+ * Parameter Smoothing Bank
+ *
+ * Linear ramps for a fixed set of continuous parameters, kept in one place
+ * instead of a smoother inside every effect and voice. Each slot reads a
+ * cached APVTS atomic; updateTargets() picks up new values once per host
+ * block and advance() moves every ramp at once, once per control tick.
+ *
+ * The ramp state is stored as aligned structure-of-arrays and advanced with
+ * a branch-free loop, so the whole bank vectorises. Logarithmic slots ramp
+ * in the log domain (cutoffs glide evenly in pitch) and are converted back
+ * in get().
+ */
+class ParameterSmoothingBank
+{
+public:
+    static constexpr int maxParameters = 64;
+
+    enum class Scale
+    {
+        Linear,
+        Logarithmic
+    };
+
+    /**
+     * Binds slot index to an APVTS value. Call from prepareToPlay, before
+     * prepare().
+     */
+    void setParameter(int index, std::atomic<float>* source, float rampSeconds = 0.02f, Scale scale = Scale::Linear)
+    {
+        jassert(index >= 0 && index < maxParameters);
+
+        sources[(size_t) index] = source;
+        rampTimes[(size_t) index] = rampSeconds;
+        logarithmic[(size_t) index] = scale == Scale::Logarithmic;
+        numParameters = juce::jmax(numParameters, index + 1);
+        numPadded = (numParameters + 3) & ~3;
+    }
+
+    /**
+     * Jumps every slot to its parameter's current value
+     */
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            rampLengths[(size_t) i] = juce::jmax(1.0f, rampTimes[(size_t) i] * static_cast<float>(sampleRate));
+            lastValues[(size_t) i] = sources[(size_t) i] != nullptr ? sources[(size_t) i]->load() : 0.0f;
+            current[(size_t) i] = target[(size_t) i] = toRampDomain(i, lastValues[(size_t) i]);
+            step[(size_t) i] = 0.0f;
+            remaining[(size_t) i] = 0.0f;
+        }
+    }
+
+    /**
+     * Starts a ramp for every parameter that moved since the last call
+     */
+    void updateTargets()
+    {
+        for (int i = 0; i < numParameters; ++i)
+        {
+            if (sources[(size_t) i] == nullptr)
+                continue;
+
+            const float value = sources[(size_t) i]->load();
+
+            if (value == lastValues[(size_t) i])
+                continue;
+
+            lastValues[(size_t) i] = value;
+            target[(size_t) i] = toRampDomain(i, value);
+            remaining[(size_t) i] = rampLengths[(size_t) i];
+            step[(size_t) i] = (target[(size_t) i] - current[(size_t) i]) / remaining[(size_t) i];
+        }
+    }
+
+    /**
+     * Moves every ramp on by numSamples, landing exactly on the target
+     */
+    void advance(int numSamples)
+    {
+        const float samples = static_cast<float>(numSamples);
+
+        for (int i = 0; i < numPadded; ++i)
+        {
+            const float stepsTaken = juce::jmin(samples, remaining[(size_t) i]);
+            remaining[(size_t) i] -= stepsTaken;
+            current[(size_t) i] = remaining[(size_t) i] > 0.0f ? current[(size_t) i] + step[(size_t) i] * stepsTaken
+                                                             : target[(size_t) i];
+        }
+    }
+
+    float get(int index) const
+    {
+        const float value = current[(size_t) index];
+        return logarithmic[(size_t) index] ? std::exp(value) : value;
+    }
+
+    bool isSmoothing(int index) const { return remaining[(size_t) index] > 0.0f; }
+
+private:
+    float toRampDomain(int index, float value) const
+    {
+        return logarithmic[(size_t) index] ? std::log(juce::jmax(value, 1.0e-6f)) : value;
+    }
+
+    // Padded slots stay at zero with nothing remaining
+    alignas(16) std::array<float, maxParameters> current {};
+    alignas(16) std::array<float, maxParameters> target {};
+    alignas(16) std::array<float, maxParameters> step {};
+    alignas(16) std::array<float, maxParameters> remaining {};
+
+    std::array<float, maxParameters> rampLengths {};
+    std::array<float, maxParameters> rampTimes {};
+    std::array<float, maxParameters> lastValues {};
+    std::array<bool, maxParameters> logarithmic {};
+    std::array<std::atomic<float>*, maxParameters> sources {};
+
+    int numParameters = 0;
+    int numPadded = 0;
+    double sampleRate = 44100.0;
+};
@@ -3057,7 +3057,9 @@ private:
             setParam(state, "filterCutoff", 8000.0f);
             setParam(state, "filterResonance", 0.6f);
             setParam(state, "filterEnv", 0.8f);
-            setParam(state, "distortion", 0.5f);
+            setParam(state, "distortionDrive", 0.5f);
+            setParam(state, "distortionMode", 3.0f); // Bitcrush
+            setParam(state, "distortionMix", 0.5f);
             Preset preset("Glitch Percussion", "FX", state, true);
             preset.author = "Factory";
             preset.tags.add("glitch");
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * One record on the telemetry channel. The meaning of values depends on
+ * the type:
+ *
+ *  - grainSpawn:      position (0-1), amplitude, pitch (semitones), size (0-1)
+ *  - grainParameters: density, size, position, texture
+ *  - voiceLevel:      level, MIDI note (-1 when free)
+ *  - lfoPhase:        phase (0-1), current value
+ *
+ * index is the voice or LFO number. count is the number of grains a
+ * grainSpawn event stands for, since only the latest one is described.
+ */
+struct TelemetryEvent
+{
+    enum class Type : juce::uint8
+    {
+        grainSpawn,
+        grainParameters,
+        voiceLevel,
+        lfoPhase
+    };
+
+    Type type = Type::grainSpawn;
+    juce::uint8 index = 0;
+    juce::uint16 count = 0;
+    std::array<float, 4> values {};
+};
+
+/**
+ * Telemetry Channel
+ *
+ * Carries display data from the audio thread to the editor without locks,
+ * allocation or messages. There are two preallocated single-producer,
+ * single-consumer rings: one of TelemetryEvents and one of mono output
+ * samples. The audio thread writes, the editor's timer reads.
+ *
+ * A full ring drops the new data instead of waiting, so a slow or hidden
+ * editor can't stall the audio thread. Nothing is written at all until an
+ * editor attaches.
+ */
+class TelemetryChannel
+{
+public:
+    static constexpr int eventCapacity = 2048;
+    static constexpr int sampleCapacity = 1 << 15;
+
+    TelemetryChannel()
+        : eventFifo(eventCapacity),
+          sampleFifo(sampleCapacity),
+          events((size_t) eventCapacity),
+          samples((size_t) sampleCapacity)
+    {
+    }
+
+    //==========================================================================
+    // Consumer (message thread)
+
+    /**
+     * Starts or stops publishing. Detaching doesn't flush the rings, so only
+     * reset() them while the producer is known to be idle.
+     */
+    void setConsumerAttached(bool shouldBeAttached)
+    {
+        consumerAttached.store(shouldBeAttached, std::memory_order_release);
+    }
+
+    /**
+     * Calls handler(const TelemetryEvent&) for every waiting event, oldest
+     * first
+     */
+    template <typename Handler>
+    void drainEvents(Handler&& handler)
+    {
+        int start1, size1, start2, size2;
+        eventFifo.prepareToRead(eventFifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            handler(events[(size_t) (start1 + i)]);
+
+        for (int i = 0; i < size2; ++i)
+            handler(events[(size_t) (start2 + i)]);
+
+        eventFifo.finishedRead(size1 + size2);
+    }
+
+    /**
+     * Copies up to maxSamples of the oldest output samples into dest and
+     * returns how many were copied
+     */
+    int readSamples(float* dest, int maxSamples)
+    {
+        int start1, size1, start2, size2;
+        sampleFifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            juce::FloatVectorOperations::copy(dest, samples.data() + start1, size1);
+
+        if (size2 > 0)
+            juce::FloatVectorOperations::copy(dest + size1, samples.data() + start2, size2);
+
+        sampleFifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    // Records and samples the producer had to throw away
+    juce::uint32 getNumDropped() const { return numDropped.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    // Producer (audio thread)
+
+    bool isConsumerAttached() const { return consumerAttached.load(std::memory_order_acquire); }
+
+    void pushEvent(const TelemetryEvent& event)
+    {
+        int start1, size1, start2, size2;
+        eventFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+        {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        events[(size_t) (size1 > 0 ? start1 : start2)] = event;
+        eventFifo.finishedWrite(1);
+    }
+
+    /**
+     * Writes the mid signal of a stereo block, (left + right) / 2
+     */
+    void pushSamples(const float* left, const float* right, int numSamples)
+    {
+        int start1, size1, start2, size2;
+        sampleFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        writeMid(samples.data() + start1, left, right, size1);
+        writeMid(samples.data() + start2, left + size1, right + size1, size2);
+
+        sampleFifo.finishedWrite(size1 + size2);
+
+        if (size1 + size2 < numSamples)
+            numDropped.fetch_add((juce::uint32) (numSamples - size1 - size2), std::memory_order_relaxed);
+    }
+
+private:
+    static void writeMid(float* dest, const float* left, const float* right, int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        juce::FloatVectorOperations::add(dest, left, right, numSamples);
+        juce::FloatVectorOperations::multiply(dest, 0.5f, numSamples);
+    }
+
+    juce::AbstractFifo eventFifo;
+    juce::AbstractFifo sampleFifo;
+    std::vector<TelemetryEvent> events;
+    std::vector<float> samples;
+
+    std::atomic<bool> consumerAttached { false };
+    std::atomic<juce::uint32> numDropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(TelemetryChannel)
+};
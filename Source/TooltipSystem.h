@@ -74,6 +74,7 @@ public:
         
         tooltips["distortionDrive"] = "Distortion Drive: Amount of saturation\nHigher = more harmonics";
         tooltips["distortionMix"] = "Distortion Mix: Blend dry/wet signal\n0% = clean, 100% = full distortion";
+        tooltips["distortionOversampling"] = "Distortion Oversampling: Runs the shaper at 2x-8x\nHigher = less aliasing, more CPU, adds latency";
         
         tooltips["delayTime"] = "Delay Time: Delay duration\nRange: 1ms - 2000ms";
         tooltips["delayFeedback"] = "Delay Feedback: Number of repeats\n0% = single echo, 95% = infinite";
@@ -82,6 +83,7 @@ public:
         tooltips["reverbSize"] = "Reverb Size: Virtual room size\nLarger = longer decay";
         tooltips["reverbDamping"] = "Reverb Damping: High frequency absorption\nHigher = darker reverb";
         tooltips["reverbShimmer"] = "Reverb Shimmer: Octave-up feedback\nAdds ethereal character";
+        tooltips["reverbMode"] = "Reverb Mode: Classic comb/allpass or FDN\nFDN 16 = densest, smoothest tail";
         
         // Apply tooltips to components
         applyTooltipsRecursive(rootComponent);
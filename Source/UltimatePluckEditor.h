@@ -618,7 +618,7 @@ private:
 //==============================================================================
 // ULTIMATE PLUCK EDITOR
 //==============================================================================
-class UltimatePluckEditor : public juce::AudioProcessorEditor
+class UltimatePluckEditor : public juce::AudioProcessorEditor, private juce::Timer
 {
 public:
     UltimatePluckEditor(UltimatePluckProcessor& p)
@@ -691,8 +691,9 @@ public:
         // Visual Feedback for visual tab
         addChildComponent(visualFeedbackPanel);
 
-        // Register visual feedback with processor
-        processor.setVisualFeedbackPanel(&visualFeedbackPanel);
+        // Visualisations are fed from the processor's telemetry channel
+        processor.getTelemetry().setConsumerAttached(true);
+        startTimerHz(60);
 
         // Setup background visualizations
         envelopeSection.setBackgroundVisualization(&spectrumAnalyzer);
@@ -797,6 +798,8 @@ public:
     
     ~UltimatePluckEditor() override
     {
+        stopTimer();
+        processor.getTelemetry().setConsumerAttached(false);
         setLookAndFeel(nullptr);
     }
     
@@ -1289,21 +1292,55 @@ private:
     }
 
     // Public methods to push audio to visualizations
-    void pushAudioToVisualizations(const float* leftChannel, const float* rightChannel, int numSamples)
+    void pushAudioToVisualizations(const float* samples, int numSamples)
     {
-        // Push to spectrum analyzer
-        for (int i = 0; i < numSamples; ++i)
-            spectrumAnalyzer.pushSample((leftChannel[i] + rightChannel[i]) * 0.5f);
+        spectrumAnalyzer.pushSamples(samples, numSamples);
+        visualFeedbackPanel.pushSamplesForSpectrum(samples, numSamples);
+    }
 
-        // Calculate RMS amplitude for grain visualizer
-        float sum = 0.0f;
-        for (int i = 0; i < numSamples; ++i)
+    // Drains everything the audio thread published since the last tick
+    void timerCallback() override
+    {
+        auto& telemetry = processor.getTelemetry();
+
+        visualFeedbackPanel.prepare(processor.getSampleRate());
+
+        std::array<float, 1024> samples;
+        int numRead = 0;
+
+        while ((numRead = telemetry.readSamples(samples.data(), (int) samples.size())) > 0)
+            pushAudioToVisualizations(samples.data(), numRead);
+
+        float loudestVoice = -1.0f;
+
+        telemetry.drainEvents([this, &loudestVoice](const TelemetryEvent& event)
         {
-            float sample = (leftChannel[i] + rightChannel[i]) * 0.5f;
-            sum += sample * sample;
-        }
-        float rms = std::sqrt(sum / numSamples);
-        grainVisualizer.triggerFromAudio(rms);
+            const auto& v = event.values;
+
+            switch (event.type)
+            {
+                case TelemetryEvent::Type::grainSpawn:
+                    visualFeedbackPanel.spawnGrain(v[0], v[1], v[2], v[3], event.count);
+                    break;
+
+                case TelemetryEvent::Type::grainParameters:
+                    visualFeedbackPanel.updateGrainParameters(v[0], v[1], v[2], v[3]);
+                    break;
+
+                case TelemetryEvent::Type::voiceLevel:
+                    loudestVoice = juce::jmax(loudestVoice, v[0]);
+                    break;
+
+                case TelemetryEvent::Type::lfoPhase:
+                    if (processor.lfoSection)
+                        processor.lfoSection->setDisplayedPhase(event.index, v[0]);
+                    break;
+            }
+        });
+
+        // No level events means no new snapshot, not silence
+        if (loudestVoice >= 0.0f)
+            grainVisualizer.triggerFromAudio(loudestVoice);
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UltimatePluckEditor)
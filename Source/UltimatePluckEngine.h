@@ -5,6 +5,8 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_data_structures/juce_data_structures.h>
 #include <array>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 /*
@@ -43,6 +45,8 @@ public:
         NumModels
     };
     
+    static constexpr int maxModes = 64;
+    
     struct ResonatorParams
     {
         float frequency = 440.0f;
@@ -51,18 +55,34 @@ public:
         float position = 0.5f;       // Strike/pluck position
         float structure = 0.5f;      // Inharmonicity amount
         ResonatorModel model = ResonatorModel::String;
+        int numModes = 0;            // 0 = getDefaultModeCount (model), max maxModes
     };
     
+    /** Inharmonic models need far more partials than the harmonic ones before
+        they stop sounding like a sine cluster. */
+    static int getDefaultModeCount(ResonatorModel model)
+    {
+        switch (model)
+        {
+            case ResonatorModel::Membrane:
+            case ResonatorModel::Bell:      return 32;
+            case ResonatorModel::String:
+            case ResonatorModel::Tube:
+            case ResonatorModel::NumModels: break;
+        }
+        
+        return 8;
+    }
+    
     void setSampleRate(double sr)
     {
         sampleRate = sr;
-        for (auto& mode : modes)
-            mode.setSampleRate(sr);
+        updateModeFrequencies();
     }
     
     void setResonatorModel(ResonatorModel model)
     {
-        currentModel = model;
+        params.model = model;
         updateModeFrequencies();
     }
     
@@ -72,135 +92,180 @@ public:
         updateModeFrequencies();
     }
     
+    // Retunes the bank without touching the ringing state (glide, vibrato)
+    void setFrequency(float frequency)
+    {
+        params.frequency = frequency;
+        updateModeFrequencies();
+    }
+    
     void trigger(float velocity)
     {
         // Excite all modes with initial impulse
         float strikePosition = params.position;
         
-        for (int i = 0; i < numModes; ++i)
+        for (int i = 0; i < numActiveModes; ++i)
         {
             // Position affects mode amplitude (like real strings)
             float positionGain = std::sin((i + 1) * juce::MathConstants<float>::pi * strikePosition);
             float amplitude = velocity * positionGain * (1.0f / (i + 1));
             
-            modes[i].excite(amplitude);
+            // Seeding the previous output with A * sin(omega) rings the mode at peak amplitude A
+            modes.y1[i] += amplitude * modes.excitation[i];
         }
     }
     
     float processSample(float input)
     {
         float output = 0.0f;
-        
-        // Sum all modal responses
-        for (int i = 0; i < numModes; ++i)
-        {
-            output += modes[i].process(input);
-        }
-        
-        return output * 0.3f; // Scale to prevent clipping
+        processBlock(&input, &output, 1);
+        return output;
     }
     
-private:
-    // Individual mode (harmonic/partial)
-    class Mode
+    // Unexcited response (zero input) of the whole bank
+    void processBlock(float* output, int numSamples)
     {
-    public:
-        void setSampleRate(double sr)
-        {
-            sampleRate = sr;
-        }
-        
-        void setFrequency(float freq)
-        {
-            frequency = freq;
-            updateCoefficients();
-        }
-        
-        void setDecay(float decay)
-        {
-            decayTime = decay;
-            updateCoefficients();
-        }
-        
-        void setBrightness(float bright)
-        {
-            brightness = bright;
-            updateCoefficients();
-        }
+        processBlock(nullptr, output, numSamples);
+    }
+    
+    /** Runs every active mode over the block. input may be nullptr for the
+        free-ringing response; output is overwritten. */
+    void processBlock(const float* input, float* output, int numSamples)
+    {
+       #if JUCE_USE_SIMD
+        using Vec = juce::dsp::SIMDRegister<float>;
+        static_assert (laneAlignment % Vec::SIMDNumElements == 0, "mode padding must fill whole registers");
         
-        void excite(float amplitude)
+        for (int i = 0; i < numSamples; ++i)
         {
-            z1 += amplitude;
+            const auto x = Vec::expand(input != nullptr ? input[i] : 0.0f);
+            auto sum = Vec::expand(0.0f);
+            
+            for (int m = 0; m < numPaddedModes; m += (int) Vec::SIMDNumElements)
+            {
+                const auto y1 = Vec::fromRawArray(modes.y1 + m);
+                const auto y2 = Vec::fromRawArray(modes.y2 + m);
+                const auto y = Vec::fromRawArray(modes.b0 + m) * x
+                             - Vec::fromRawArray(modes.a1 + m) * y1
+                             - Vec::fromRawArray(modes.a2 + m) * y2;
+                
+                y1.copyToRawArray(modes.y2 + m);
+                y.copyToRawArray(modes.y1 + m);
+                sum += y;
+            }
+            
+            output[i] = sum.sum() * 0.3f; // Scale to prevent clipping
         }
-        
-        float process(float input)
+       #else
+        for (int i = 0; i < numSamples; ++i)
         {
-            // Resonant filter (like a tuned bandpass)
-            float output = b0 * input + b1 * z1 + b2 * z2 - a1 * out1 - a2 * out2;
+            const float x = input != nullptr ? input[i] : 0.0f;
+            float sum = 0.0f;
             
-            // Update delays
-            z2 = z1;
-            z1 = input;
-            out2 = out1;
-            out1 = output;
+            for (int m = 0; m < numPaddedModes; ++m)
+            {
+                const float y = modes.b0[m] * x - modes.a1[m] * modes.y1[m] - modes.a2[m] * modes.y2[m];
+                modes.y2[m] = modes.y1[m];
+                modes.y1[m] = y;
+                sum += y;
+            }
             
-            return output;
+            output[i] = sum * 0.3f; // Scale to prevent clipping
         }
+       #endif
         
-    private:
-        double sampleRate = 44100.0;
-        float frequency = 440.0f;
-        float decayTime = 1.0f;
-        float brightness = 0.5f;
-        
-        // Filter coefficients
-        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
-        float a1 = 0.0f, a2 = 0.0f;
-        
-        // State variables
-        float z1 = 0.0f, z2 = 0.0f;
-        float out1 = 0.0f, out2 = 0.0f;
-        
-        void updateCoefficients()
+        // Flush decayed modes to zero rather than letting them go denormal
+        for (int m = 0; m < numPaddedModes; ++m)
         {
-            // Bandpass resonator with decay
-            float omega = juce::MathConstants<float>::twoPi * frequency / sampleRate;
-            float bandwidth = frequency / (10.0f + brightness * 90.0f);
-            float bw = juce::MathConstants<float>::twoPi * bandwidth / sampleRate;
-            
-            // Decay coefficient
-            float decay = std::exp(-1.0f / (decayTime * sampleRate));
-            
-            // Bandpass coefficients with resonance
-            float r = decay;
-            b0 = (1.0f - r * r) * std::sin(bw);
-            b1 = 0.0f;
-            b2 = 0.0f;
-            a1 = -2.0f * r * std::cos(omega);
-            a2 = r * r;
+            JUCE_SNAP_TO_ZERO(modes.y1[m]);
+            JUCE_SNAP_TO_ZERO(modes.y2[m]);
         }
+    }
+    
+    // True once every mode's state has decayed below threshold
+    bool isSilent(float threshold) const
+    {
+        float energy = 0.0f;
+        
+        for (int m = 0; m < numPaddedModes; ++m)
+            energy += std::abs(modes.y1[m]) + std::abs(modes.y2[m]);
+        
+        return energy * 0.3f < threshold;
+    }
+    
+private:
+    // Active modes are padded up to a multiple of this so the bank always
+    // processes whole SIMD registers (covers up to 16 float lanes)
+    static constexpr int laneAlignment = 16;
+    
+    /** Structure-of-arrays two-pole resonator bank. Padding lanes and modes
+        above Nyquist keep all-zero coefficients, so they stay silent. */
+    struct ModeBank
+    {
+        alignas (64) float b0[maxModes] {};
+        alignas (64) float a1[maxModes] {};
+        alignas (64) float a2[maxModes] {};
+        alignas (64) float excitation[maxModes] {};
+        alignas (64) float y1[maxModes] {};
+        alignas (64) float y2[maxModes] {};
     };
     
-    static constexpr int numModes = 8; // 8 harmonics/partials
-    std::array<Mode, numModes> modes;
+    ModeBank modes;
+    int numActiveModes = 8;
+    int numPaddedModes = laneAlignment;
     
     ResonatorParams params;
-    ResonatorModel currentModel = ResonatorModel::String;
     double sampleRate = 44100.0;
     
+    static float getBellRatio(int index)
+    {
+        static constexpr float bellRatios[] = {1.0f, 2.76f, 5.4f, 8.93f, 13.34f, 18.64f, 24.8f, 31.87f};
+        
+        if (index < 8)
+            return bellRatios[index];
+        
+        // Beyond the measured table the ratio gaps keep widening by ~0.88
+        float ratio = bellRatios[7];
+        float gap = 7.07f;
+        
+        for (int i = 8; i <= index; ++i)
+        {
+            gap += 0.88f;
+            ratio += gap;
+        }
+        
+        return ratio;
+    }
+    
     void updateModeFrequencies()
     {
+        const int requestedModes = params.numModes > 0 ? params.numModes : getDefaultModeCount(params.model);
+        const int newActiveModes = juce::jlimit(1, maxModes, requestedModes);
+        const int newPaddedModes = ((newActiveModes + laneAlignment - 1) / laneAlignment) * laneAlignment;
+        
+        // Silence modes that drop out so they can't ring again when re-enabled
+        for (int i = newActiveModes; i < numPaddedModes; ++i)
+            modes.y1[i] = modes.y2[i] = 0.0f;
+        
+        numActiveModes = newActiveModes;
+        numPaddedModes = newPaddedModes;
+        
         float baseFreq = params.frequency;
         float inharmonicity = params.structure;
         
-        for (int i = 0; i < numModes; ++i)
+        // Decay is shared by all modes
+        const float decayTime = params.damping * 2.0f;
+        const float r = std::exp(-1.0f / (decayTime * (float) sampleRate));
+        const float nyquistLimit = 0.49f * (float) sampleRate;
+        
+        for (int i = 0; i < numPaddedModes; ++i)
         {
             float harmonic = i + 1;
             
             // Different harmonic series for different models
             float modeFreq = baseFreq;
             
-            switch (currentModel)
+            switch (params.model)
             {
                 case ResonatorModel::String:
                     // Nearly harmonic with slight inharmonicity
@@ -218,21 +283,153 @@ private:
                     break;
 
                 case ResonatorModel::Bell:
-                {
                     // Highly inharmonic (metallic)
-                    float bellRatios[] = {1.0f, 2.76f, 5.4f, 8.93f, 13.34f, 18.64f, 24.8f, 31.87f};
-                    modeFreq = baseFreq * bellRatios[i] * (1.0f + inharmonicity * 0.1f);
+                    modeFreq = baseFreq * getBellRatio(i) * (1.0f + inharmonicity * 0.1f);
                     break;
-                }
 
                 case ResonatorModel::NumModels:
                     // This case should not be reached
                     break;
             }
             
-            modes[i].setFrequency(modeFreq);
-            modes[i].setDecay(params.damping * 2.0f);
-            modes[i].setBrightness(params.brightness);
+            if (i >= numActiveModes || modeFreq >= nyquistLimit)
+            {
+                modes.b0[i] = modes.a1[i] = modes.a2[i] = modes.excitation[i] = 0.0f;
+                modes.y1[i] = modes.y2[i] = 0.0f;
+                continue;
+            }
+            
+            // Bandpass resonator with decay
+            float omega = juce::MathConstants<float>::twoPi * modeFreq / (float) sampleRate;
+            float bandwidth = modeFreq / (10.0f + params.brightness * 90.0f);
+            float bw = juce::MathConstants<float>::twoPi * bandwidth / (float) sampleRate;
+            
+            modes.b0[i] = (1.0f - r * r) * std::sin(bw);
+            modes.a1[i] = -2.0f * r * std::cos(omega);
+            modes.a2[i] = r * r;
+            modes.excitation[i] = std::sin(omega);
+        }
+    }
+};
+
+//==============================================================================
+// GRANULAR CAPTURE BUFFER - mono ring buffer the grains read from
+//==============================================================================
+class GranularCaptureBuffer
+{
+public:
+    static constexpr double defaultLengthSeconds = 4.0;
+    
+    // Allocates, so call from prepareToPlay (or with processing suspended)
+    void prepare(double sampleRate, double lengthSeconds = defaultLengthSeconds)
+    {
+        const int numSamples = juce::jmax(1, (int) std::ceil(sampleRate * lengthSeconds));
+        buffer.assign((size_t) numSamples, 0.0f);
+        writePos = 0;
+    }
+    
+    // Frees the storage, e.g. for voices that read from a shared buffer
+    void release()
+    {
+        std::vector<float>().swap(buffer);
+        writePos = 0;
+    }
+    
+    bool isPrepared() const { return ! buffer.empty(); }
+    int getNumSamples() const { return (int) buffer.size(); }
+    
+    // Linearly interpolated read; position is in samples and wraps both ways
+    float read(float position) const
+    {
+        const int size = getNumSamples();
+        if (size == 0)
+            return 0.0f;
+        
+        const float floorPos = std::floor(position);
+        const float frac = position - floorPos;
+        
+        int pos = (int) floorPos % size;
+        if (pos < 0)
+            pos += size;
+        
+        const int nextPos = pos + 1 < size ? pos + 1 : 0;
+        return buffer[(size_t) pos] + frac * (buffer[(size_t) nextPos] - buffer[(size_t) pos]);
+    }
+    
+    // Single-writer mode: appends the block and advances the write head
+    void write(const float* input, int numSamples)
+    {
+        if (buffer.empty())
+            return;
+        
+        forEachSpan(writePos, numSamples, [&](float* dest, int offset, int length)
+        {
+            juce::FloatVectorOperations::copy(dest, input + offset, length);
+        });
+        
+        advance(numSamples);
+    }
+    
+    // Shared mode: the owner brackets every audio block with beginSharedBlock()
+    // and endSharedBlock(); in between, each voice sums its input into the
+    // block at the sample offset it is rendering.
+    void beginSharedBlock(int numSamples)
+    {
+        if (buffer.empty() || frozen)
+            return;
+        
+        forEachSpan(writePos, numSamples, [](float* dest, int, int length)
+        {
+            juce::FloatVectorOperations::clear(dest, length);
+        });
+    }
+    
+    void accumulate(const float* input, int numSamples, int blockOffset)
+    {
+        if (buffer.empty() || frozen)
+            return;
+        
+        forEachSpan((writePos + blockOffset) % getNumSamples(), numSamples, [&](float* dest, int offset, int length)
+        {
+            juce::FloatVectorOperations::add(dest, input + offset, length);
+        });
+    }
+    
+    void endSharedBlock(int numSamples)
+    {
+        if (! buffer.empty() && ! frozen)
+            advance(numSamples);
+    }
+    
+    // While frozen a shared block neither clears, sums into nor advances the
+    // ring, so it keeps what it held. Set by the owner between blocks.
+    void setFrozen(bool shouldBeFrozen) { frozen = shouldBeFrozen; }
+    bool isFrozen() const { return frozen; }
+    
+private:
+    std::vector<float> buffer;
+    int writePos = 0;
+    bool frozen = false;
+    
+    void advance(int numSamples)
+    {
+        writePos = (writePos + numSamples) % getNumSamples();
+    }
+    
+    // Calls fn(pointer, offsetIntoBlock, length) for the one or two contiguous
+    // spans covering [start, start + numSamples) in the ring
+    template <typename Fn>
+    void forEachSpan(int start, int numSamples, Fn&& fn)
+    {
+        const int size = getNumSamples();
+        int done = 0;
+        
+        while (done < numSamples)
+        {
+            const int length = juce::jmin(numSamples - done, size - start);
+            fn(buffer.data() + start, done, length);
+            done += length;
+            start = 0;
         }
     }
 };
@@ -243,15 +440,18 @@ private:
 class GranularEngine
 {
 public:
+    static constexpr int maxGrains = 256;
+    
+    // Everything that doesn't change over a grain's life is baked in at spawn
     struct Grain
     {
-        bool active = false;
-        float position = 0.0f;      // Position in buffer
-        float phase = 0.0f;         // Grain playback phase
-        float duration = 0.1f;      // Grain length
-        float pitch = 1.0f;         // Playback speed
-        float pan = 0.5f;           // Stereo position
-        float amplitude = 1.0f;     // Grain volume
+        float position = 0.0f;      // Start offset from the read position, in samples
+        float phase = 0.0f;         // Grain playback phase (0-1)
+        float phaseIncrement = 0.0f; // Per-sample phase step (1 / length)
+        float readOffset = 0.0f;    // Samples travelled so far (pitch shifted)
+        float readIncrement = 0.0f; // Per-sample read step
+        float leftGain = 0.0f;      // Pan * amplitude
+        float rightGain = 0.0f;
     };
     
     struct CloudsParams
@@ -267,16 +467,27 @@ public:
         bool freeze = false;        // Freeze input
     };
     
-    GranularEngine()
+    void setSampleRate(double sr)
     {
-        // Allocate 4 second buffer at 48kHz
-        inputBuffer.setSize(2, 48000 * 4);
-        inputBuffer.clear();
+        sampleRate = sr;
     }
     
-    void setSampleRate(double sr)
+    /** Sizes the capture buffer for the sample rate. With a shared buffer the
+        engine writes into and reads from that one instead of owning storage;
+        the shared buffer's owner must bracket each block (see
+        GranularCaptureBuffer::beginSharedBlock). */
+    void prepare(double sr, GranularCaptureBuffer* sharedBuffer = nullptr)
     {
         sampleRate = sr;
+        sharedCapture = sharedBuffer;
+        
+        if (sharedCapture != nullptr)
+            ownCapture.release();
+        else
+            ownCapture.prepare(sr);
+        
+        // A freshly allocated buffer is all zeros
+        quietCaptureSamples = ownCapture.getNumSamples();
     }
     
     void setParameters(const CloudsParams& p)
@@ -284,17 +495,41 @@ public:
         params = p;
     }
     
-    void writeInput(float leftSample, float rightSample)
+    // blockOffset is where this block starts within the host block; only the
+    // shared buffer needs it
+    void captureInput(const float* input, int numSamples, int blockOffset)
     {
         if (params.freeze)
             return; // Don't update buffer when frozen
         
-        inputBuffer.setSample(0, writePos, leftSample);
-        inputBuffer.setSample(1, writePos, rightSample);
-        
-        writePos = (writePos + 1) % inputBuffer.getNumSamples();
+        if (sharedCapture != nullptr)
+        {
+            sharedCapture->accumulate(input, numSamples, blockOffset);
+        }
+        else
+        {
+            ownCapture.write(input, numSamples);
+            
+            // Track how much of the buffer has been overwritten by silence
+            const auto range = juce::FloatVectorOperations::findMinAndMax(input, numSamples);
+            if (juce::jmax(-range.getStart(), range.getEnd()) < silenceThreshold)
+                quietCaptureSamples = juce::jmin(quietCaptureSamples + numSamples, ownCapture.getNumSamples());
+            else
+                quietCaptureSamples = 0;
+        }
+    }
+    
+    /** True once the whole private capture buffer holds only silence, so no
+        grain can make a sound. A frozen or shared buffer is never treated as
+        silent: this voice can't tell what it contains. */
+    bool isSilent() const
+    {
+        return ! params.freeze && sharedCapture == nullptr
+            && quietCaptureSamples >= ownCapture.getNumSamples();
     }
     
+    static constexpr float silenceThreshold = 1.0e-6f; // -120 dBFS
+    
     void processStereo(float& left, float& right)
     {
         // Grain density determines spawn rate
@@ -305,115 +540,298 @@ public:
             spawnGrain();
         }
         
-        // Process all active grains
+        // Process active grains only; finished ones are swap-removed
         left = 0.0f;
         right = 0.0f;
-        int activeCount = 0;
         
-        for (auto& grain : grains)
+        const auto& capture = getCapture();
+        const auto& tables = getTables();
+        const float readBase = params.position * (float) capture.getNumSamples();
+        
+        for (int i = 0; i < numActiveGrains;)
         {
-            if (!grain.active)
-                continue;
-            
-            // Read from input buffer at grain's position
-            float readPos = params.position * inputBuffer.getNumSamples() + 
-                          grain.position * inputBuffer.getNumSamples() * 0.1f;
-            
-            // Handle pitch shifting
-            readPos += grain.phase * grain.pitch * inputBuffer.getNumSamples();
+            const int index = activeGrains[(size_t) i];
+            auto& grain = grains[(size_t) index];
             
-            int pos = (int)readPos % inputBuffer.getNumSamples();
-            float frac = readPos - (int)readPos;
+            // Capture is mono, the baked pan gains make it stereo
+            const float sample = capture.read(readBase + grain.position + grain.readOffset)
+                               * tables.window(grain.phase);
             
-            // Linear interpolation
-            int nextPos = (pos + 1) % inputBuffer.getNumSamples();
-            float sampleL = inputBuffer.getSample(0, pos) * (1 - frac) + 
-                          inputBuffer.getSample(0, nextPos) * frac;
-            float sampleR = inputBuffer.getSample(1, pos) * (1 - frac) + 
-                          inputBuffer.getSample(1, nextPos) * frac;
-            
-            // Apply grain envelope (Hann window)
-            float env = 0.5f * (1.0f - std::cos(grain.phase * juce::MathConstants<float>::twoPi));
-            
-            // Apply amplitude
-            sampleL *= env * grain.amplitude;
-            sampleR *= env * grain.amplitude;
-            
-            // Pan
-            float leftGain = std::cos(grain.pan * juce::MathConstants<float>::halfPi);
-            float rightGain = std::sin(grain.pan * juce::MathConstants<float>::halfPi);
-            
-            left += sampleL * leftGain;
-            right += sampleR * rightGain;
+            left += sample * grain.leftGain;
+            right += sample * grain.rightGain;
             
             // Update grain
-            grain.phase += 1.0f / (grain.duration * sampleRate);
+            grain.phase += grain.phaseIncrement;
+            grain.readOffset += grain.readIncrement;
             
             if (grain.phase >= 1.0f)
-                grain.active = false;
+            {
+                freeGrains[(size_t) numFreeGrains++] = index;
+                activeGrains[(size_t) i] = activeGrains[(size_t) --numActiveGrains];
+            }
             else
-                activeCount++;
+            {
+                ++i;
+            }
         }
         
-        // Normalize by active grain count
-        if (activeCount > 0)
-        {
-            float norm = 1.0f / std::sqrt(activeCount);
-            left *= norm;
-            right *= norm;
-        }
+        // Normalize by the number of grains still playing
+        const float norm = tables.inverseSqrt[(size_t) numActiveGrains];
+        left *= norm;
+        right *= norm;
+    }
+    
+    int getNumActiveGrains() const { return numActiveGrains; }
+    
+    // The most recent grain, for display
+    struct SpawnInfo
+    {
+        float position = 0.0f;      // Read position (0-1)
+        float amplitude = 0.0f;
+        float pitch = 0.0f;         // Semitones
+        float size = 0.0f;          // Grain size parameter (0-1)
+    };
+    
+    // Counts every grain ever spawned; wraps around
+    juce::uint32 getNumGrainsSpawned() const { return numGrainsSpawned; }
+    const SpawnInfo& getLastSpawn() const { return lastSpawn; }
+    
+    // Feeds a mono input block into the buffer and renders the grain cloud
+    void processBlock(const float* input, float* outLeft, float* outRight, int numSamples, int blockOffset = 0)
+    {
+        captureInput(input, numSamples, blockOffset);
+        
+        for (int i = 0; i < numSamples; ++i)
+            processStereo(outLeft[i], outRight[i]);
     }
     
 private:
-    juce::AudioBuffer<float> inputBuffer;
-    std::vector<Grain> grains{64}; // Up to 64 simultaneous grains
+    GranularCaptureBuffer ownCapture;
+    GranularCaptureBuffer* sharedCapture = nullptr;
+    int quietCaptureSamples = 0;
     CloudsParams params;
     juce::Random random;
     double sampleRate = 44100.0;
-    int writePos = 0;
     
-    void spawnGrain()
+    // Grain pool: a dense list of playing grain indices plus a free stack
+    std::array<Grain, maxGrains> grains;
+    std::array<int, maxGrains> activeGrains;
+    std::array<int, maxGrains> freeGrains = makeFreeList();
+    int numActiveGrains = 0;
+    int numFreeGrains = maxGrains;
+    
+    juce::uint32 numGrainsSpawned = 0;
+    SpawnInfo lastSpawn;
+    
+    static std::array<int, maxGrains> makeFreeList()
+    {
+        std::array<int, maxGrains> list;
+        for (int i = 0; i < maxGrains; ++i)
+            list[(size_t) i] = maxGrains - 1 - i;
+        return list;
+    }
+    
+    // Hann window and 1 / sqrt(n) lookups, shared by every engine
+    struct Tables
     {
-        for (auto& grain : grains)
+        static constexpr int windowSize = 1024;
+        std::array<float, windowSize + 1> hann;
+        std::array<float, maxGrains + 1> inverseSqrt;
+        
+        Tables()
         {
-            if (grain.active)
-                continue;
-            
-            grain.active = true;
-            grain.phase = 0.0f;
+            for (int i = 0; i <= windowSize; ++i)
+                hann[(size_t) i] = 0.5f * (1.0f - std::cos(juce::MathConstants<float>::twoPi * (float) i / (float) windowSize));
             
-            // Randomize position based on texture
-            float positionSpread = params.texture * 0.2f;
-            grain.position = (random.nextFloat() - 0.5f) * positionSpread;
-            
-            // Grain size from params
-            grain.duration = 0.01f + params.size * 0.5f; // 10ms to 510ms
+            inverseSqrt[0] = 1.0f;
+            for (int n = 1; n <= maxGrains; ++n)
+                inverseSqrt[(size_t) n] = 1.0f / std::sqrt((float) n);
+        }
+        
+        // phase in [0, 1)
+        float window(float phase) const
+        {
+            const float pos = phase * (float) windowSize;
+            const int index = (int) pos;
+            const float frac = pos - (float) index;
+            return hann[(size_t) index] + frac * (hann[(size_t) index + 1] - hann[(size_t) index]);
+        }
+    };
+    
+    static const Tables& getTables()
+    {
+        static const Tables tables;
+        return tables;
+    }
+    
+    const GranularCaptureBuffer& getCapture() const
+    {
+        return sharedCapture != nullptr ? *sharedCapture : ownCapture;
+    }
+    
+    void spawnGrain()
+    {
+        if (numFreeGrains == 0)
+            return;
+        
+        const int index = freeGrains[(size_t) --numFreeGrains];
+        activeGrains[(size_t) numActiveGrains++] = index;
+        auto& grain = grains[(size_t) index];
+        
+        const float bufferLength = (float) getCapture().getNumSamples();
+        
+        grain.phase = 0.0f;
+        grain.readOffset = 0.0f;
+        
+        // Randomize position based on texture (up to +-1% of the buffer)
+        float positionSpread = params.texture * 0.2f;
+        grain.position = (random.nextFloat() - 0.5f) * positionSpread * bufferLength * 0.1f;
+        
+        // Grain size from params
+        float duration = 0.01f + params.size * 0.5f; // 10ms to 510ms
+        grain.phaseIncrement = 1.0f / (duration * (float) sampleRate);
+        
+        // Pitch from params with slight randomization
+        float pitchSemitones = params.pitch * 12.0f;
+        pitchSemitones += (random.nextFloat() - 0.5f) * params.texture * 2.0f;
+        float pitch = std::exp2(pitchSemitones / 12.0f);
+        grain.readIncrement = grain.phaseIncrement * pitch * bufferLength;
+        
+        // Random pan based on stereo spread
+        float pan = 0.5f + (random.nextFloat() - 0.5f) * params.stereoSpread;
+        
+        // Random amplitude variation
+        float amplitude = 0.8f + random.nextFloat() * 0.4f;
+        
+        grain.leftGain = amplitude * std::cos(pan * juce::MathConstants<float>::halfPi);
+        grain.rightGain = amplitude * std::sin(pan * juce::MathConstants<float>::halfPi);
+        
+        ++numGrainsSpawned;
+        lastSpawn.position = juce::jlimit(0.0f, 1.0f, params.position + grain.position / bufferLength);
+        lastSpawn.amplitude = amplitude;
+        lastSpawn.pitch = pitchSemitones;
+        lastSpawn.size = params.size;
+    }
+};
+
+//==============================================================================
+// ADVANCED WAVETABLE ENGINE (Pigments-style)
+//==============================================================================
+/** Immutable set of band-limited wavetables, built once and shared by every
+    voice of every plugin instance in the process.
+    
+    Each table is stored at several mip levels: level k only keeps partials
+    up to (topPartial >> k) cycles per table, so at a given playback rate we
+    can pick the richest level that still stays below Nyquist. */
+class WavetableBank
+{
+public:
+    static constexpr int tableSize = 2048;
+    static constexpr int numTables = 32;
+    static constexpr int topPartial = 64;   // Level 0 limit, above the richest table
+    static constexpr int numLevels = 7;     // 64, 32, ... 1 cycles per table
+    
+    static std::shared_ptr<const WavetableBank> getShared()
+    {
+        static std::mutex mutex;
+        static std::weak_ptr<const WavetableBank> instance;
+        
+        const std::lock_guard<std::mutex> lock(mutex);
+        
+        auto bank = instance.lock();
+        if (bank == nullptr)
+        {
+            bank = std::shared_ptr<const WavetableBank>(new WavetableBank());
+            instance = bank;
+        }
+        
+        return bank;
+    }
+    
+    // Richest level whose partials stay below Nyquist at this phase increment
+    static int getLevelForIncrement(float phaseIncrement)
+    {
+        int level = 0;
+        float highestPartial = (float) topPartial;
+        
+        while (level < numLevels - 1 && highestPartial * phaseIncrement >= 0.5f)
+        {
+            highestPartial *= 0.5f;
+            ++level;
+        }
+        
+        return level;
+    }
+    
+    // tableSize samples plus one guard sample for interpolation
+    const float* getTable(int tableIndex, int level) const
+    {
+        tableIndex = juce::jlimit(0, numTables - 1, tableIndex);
+        return data.data() + (size_t) (tableIndex * numLevels + level) * (size_t) (tableSize + 1);
+    }
+    
+private:
+    std::vector<float> data;
+    
+    WavetableBank()
+        : data((size_t) (numTables * numLevels * (tableSize + 1)), 0.0f)
+    {
+        std::vector<float> partialSum((size_t) tableSize);
+        
+        for (int table = 0; table < numTables; ++table)
+        {
+            float tablePos = table / 31.0f;
             
-            // Pitch from params with slight randomization
-            float pitchSemitones = params.pitch * 12.0f;
-            pitchSemitones += (random.nextFloat() - 0.5f) * params.texture * 2.0f;
-            grain.pitch = std::pow(2.0f, pitchSemitones / 12.0f);
+            // Morph through different harmonic content
+            int numHarmonics = 1 + (int)(tablePos * 16);
+            std::fill(partialSum.begin(), partialSum.end(), 0.0f);
             
-            // Random pan based on stereo spread
-            grain.pan = 0.5f + (random.nextFloat() - 0.5f) * params.stereoSpread;
+            // Partials rise monotonically with h, so each level is a prefix of
+            // the sum: add partials in order and snapshot the running sum into
+            // every level whose limit the next partial would exceed
+            int nextLevel = numLevels - 1;
             
-            // Random amplitude variation
-            grain.amplitude = 0.8f + random.nextFloat() * 0.4f;
+            for (int h = 1; h <= numHarmonics; ++h)
+            {
+                float amplitude = 1.0f / h;
+                
+                // Add inharmonicity based on table position
+                float freqMult = h * (1.0f + tablePos * 0.1f * h);
+                
+                // The fundamental is always kept so no level goes silent
+                while (h > 1 && nextLevel >= 0 && freqMult > (float) (topPartial >> nextLevel))
+                    storeLevel(table, nextLevel--, partialSum, numHarmonics);
+                
+                for (int i = 0; i < tableSize; ++i)
+                {
+                    float phase = i / float(tableSize);
+                    partialSum[(size_t) i] += amplitude * std::sin(freqMult * phase * juce::MathConstants<float>::twoPi);
+                }
+            }
             
-            break;
+            while (nextLevel >= 0)
+                storeLevel(table, nextLevel--, partialSum, numHarmonics);
         }
     }
+    
+    // Normalised by the full harmonic count so levels match in loudness
+    void storeLevel(int table, int level, const std::vector<float>& partialSum, int numHarmonics)
+    {
+        auto* dest = data.data() + (size_t) (table * numLevels + level) * (size_t) (tableSize + 1);
+        
+        for (int i = 0; i < tableSize; ++i)
+            dest[i] = partialSum[(size_t) i] / numHarmonics;
+        
+        dest[tableSize] = dest[0];
+    }
 };
 
-//==============================================================================
-// ADVANCED WAVETABLE ENGINE (Pigments-style)
-//==============================================================================
 class AdvancedWavetableEngine
 {
 public:
     AdvancedWavetableEngine()
+        : bank(WavetableBank::getShared())
     {
-        generateWavetables();
     }
     
     struct WavetableParams
@@ -426,11 +844,73 @@ public:
         float formant = 0.0f;    // Formant shift
     };
     
+    // Also picks the mip level, so call it whenever the pitch changes
+    void setPhaseIncrement(float increment)
+    {
+        phaseIncrement = targetIncrement = increment;
+        incrementStep = 0.0f;
+        mipLevel = WavetableBank::getLevelForIncrement(increment);
+    }
+    
+    // Glides to increment over the next numSamples (which the caller must
+    // render before ramping again); the mip level follows the target
+    void rampPhaseIncrement(float increment, int numSamples)
+    {
+        phaseIncrement = targetIncrement;
+        targetIncrement = increment;
+        incrementStep = (targetIncrement - phaseIncrement) / (float) juce::jmax(1, numSamples);
+        mipLevel = WavetableBank::getLevelForIncrement(juce::jmax(phaseIncrement, targetIncrement));
+    }
+    
+    void resetPhase()
+    {
+        phase = 0.0f;
+    }
+    
+    // Renders numSamples from the internal phase. Warp and fold are decided
+    // once per block so each inner loop does a single kind of work.
+    void processBlock(float* output, int numSamples, const WavetableParams& params)
+    {
+        const float* tableA = bank->getTable(params.tableA, mipLevel);
+        
+        if (params.warp != 0.0f)
+        {
+            // Warp replaces the morph (same as getSample)
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float warpedPhase = phase + params.warp * std::sin(phase * juce::MathConstants<float>::twoPi);
+                warpedPhase = std::fmod(warpedPhase, 1.0f);
+                if (warpedPhase < 0) warpedPhase += 1.0f;
+                output[i] = readTable(tableA, warpedPhase);
+                advancePhase();
+            }
+        }
+        else
+        {
+            const float* tableB = bank->getTable(params.tableB, mipLevel);
+            
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float sampleA = readTable(tableA, phase);
+                float sampleB = readTable(tableB, phase);
+                output[i] = sampleA + params.morph * (sampleB - sampleA);
+                advancePhase();
+            }
+        }
+        
+        if (params.fold > 0.0f)
+        {
+            float foldAmount = 1.0f + params.fold * 8.0f;
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = std::sin(output[i] * foldAmount);
+        }
+    }
+    
     float getSample(float phase, const WavetableParams& params)
     {
         // Read from both wavetables
-        float sampleA = readTable(phase, params.tableA);
-        float sampleB = readTable(phase, params.tableB);
+        float sampleA = readTable(bank->getTable(params.tableA, mipLevel), phase);
+        float sampleB = readTable(bank->getTable(params.tableB, mipLevel), phase);
         
         // Morph between them
         float morphed = sampleA + params.morph * (sampleB - sampleA);
@@ -441,7 +921,7 @@ public:
             float warpedPhase = phase + params.warp * std::sin(phase * juce::MathConstants<float>::twoPi);
             warpedPhase = std::fmod(warpedPhase, 1.0f);
             if (warpedPhase < 0) warpedPhase += 1.0f;
-            morphed = readTable(warpedPhase, params.tableA);
+            morphed = readTable(bank->getTable(params.tableA, mipLevel), warpedPhase);
         }
         
         // Apply wavefold
@@ -454,54 +934,34 @@ public:
         return morphed;
     }
     
-    int getNumTables() const { return (int)wavetables.size(); }
+    int getNumTables() const { return WavetableBank::numTables; }
     
 private:
-    static constexpr int tableSize = 2048;
-    std::vector<std::array<float, tableSize>> wavetables;
+    static constexpr int tableSize = WavetableBank::tableSize;
+    std::shared_ptr<const WavetableBank> bank;
+    int mipLevel = 0;
+    float phase = 0.0f;
+    float phaseIncrement = 0.0f;
+    float targetIncrement = 0.0f;
+    float incrementStep = 0.0f;
     
-    float readTable(float phase, int tableIndex)
+    void advancePhase()
     {
-        tableIndex = juce::jlimit(0, (int)wavetables.size() - 1, tableIndex);
-        
-        float pos = phase * tableSize;
-        int index1 = (int)pos % tableSize;
-        int index2 = (index1 + 1) % tableSize;
-        float frac = pos - (int)pos;
+        phase += phaseIncrement;
+        if (phase >= 1.0f)
+            phase -= 1.0f;
         
-        return wavetables[tableIndex][index1] + frac * 
-              (wavetables[tableIndex][index2] - wavetables[tableIndex][index1]);
+        phaseIncrement += incrementStep;
     }
     
-    void generateWavetables()
+    // phase in [0, 1); the table's guard sample covers index + 1
+    static float readTable(const float* table, float phase)
     {
-        wavetables.resize(32); // 32 wavetables for morphing
+        float pos = phase * tableSize;
+        int index1 = (int)pos & (tableSize - 1);
+        float frac = pos - (int)pos;
         
-        for (int table = 0; table < 32; ++table)
-        {
-            float tablePos = table / 31.0f;
-            
-            for (int i = 0; i < tableSize; ++i)
-            {
-                float phase = i / float(tableSize);
-                float sample = 0.0f;
-                
-                // Morph through different harmonic content
-                int numHarmonics = 1 + (int)(tablePos * 16);
-                
-                for (int h = 1; h <= numHarmonics; ++h)
-                {
-                    float amplitude = 1.0f / h;
-                    
-                    // Add inharmonicity based on table position
-                    float freqMult = h * (1.0f + tablePos * 0.1f * h);
-                    
-                    sample += amplitude * std::sin(freqMult * phase * juce::MathConstants<float>::twoPi);
-                }
-                
-                wavetables[table][i] = sample / numHarmonics;
-            }
-        }
+        return table[index1] + frac * (table[index1 + 1] - table[index1]);
     }
 };
 
@@ -516,52 +976,139 @@ public:
         sampleRate = sr;
     }
     
+    /** Allocates the delay line for the lowest note we can be asked to play,
+        so setFrequency() never has to. Call from prepareToPlay. */
+    void prepare(double sr, float lowestFrequency = 8.0f)
+    {
+        sampleRate = sr;
+        
+        const int maxDelay = (int) std::ceil(sampleRate / lowestFrequency) + 2;
+        delayLine.assign((size_t) juce::nextPowerOfTwo(maxDelay), 0.0f);
+        mask = (int) delayLine.size() - 1;
+        writePos = 0;
+        
+        setFrequency(frequency);
+    }
+    
     void setFrequency(float freq)
     {
         frequency = freq;
-        delayLength = sampleRate / frequency;
         
-        // Resize delay line
-        delayLine.resize((int)delayLength + 1, 0.0f);
-        writePos = 0;
+        if (delayLine.empty())
+            return;
+        
+        // The loop is N samples of delay line + half a sample from the
+        // averaging filter + a first-order allpass for the rest. Keeping the
+        // allpass delay in [0.5, 1.5) keeps it well behaved.
+        const float period = (float) (sampleRate / frequency);
+        delayLength = juce::jlimit(1, mask - 1, (int) std::floor(period - 1.0f));
+        
+        const float fractionalDelay = juce::jmax(0.5f, period - 0.5f - (float) delayLength);
+        
+        // Thiran's (1 - d) / (1 + d) is exact at DC only and goes flat at the
+        // top of the keyboard; this form is exact at the fundamental instead
+        const float omega = juce::MathConstants<float>::twoPi / period;
+        allpassCoefficient = std::sin(0.5f * omega * (1.0f - fractionalDelay))
+                           / std::sin(0.5f * omega * (1.0f + fractionalDelay));
     }
     
     void trigger(float velocity)
     {
-        // Fill delay line with noise burst
-        for (size_t i = 0; i < delayLine.size(); ++i)
+        if (delayLine.empty())
+            return;
+        
+        // Fill the next period of the delay line with a noise burst
+        for (int i = 1; i <= delayLength; ++i)
         {
-            delayLine[i] = (random.nextFloat() * 2.0f - 1.0f) * velocity;
+            delayLine[(size_t) ((writePos - i) & mask)] = (random.nextFloat() * 2.0f - 1.0f) * velocity;
         }
+        
+        previousInput = (random.nextFloat() * 2.0f - 1.0f) * velocity;
+        allpassInput = allpassOutput = 0.0f;
+        quietSamples = 0;
     }
     
     float getSample()
     {
-        // Read from delay line
-        float output = delayLine[writePos];
+        float output = 0.0f;
+        processBlock(&output, 1);
+        return output;
+    }
+    
+    void processBlock(float* output, int numSamples)
+    {
+        if (delayLine.empty())
+        {
+            juce::FloatVectorOperations::clear(output, numSamples);
+            return;
+        }
         
-        // Karplus-Strong averaging filter
-        int prevPos = (writePos - 1 + delayLine.size()) % delayLine.size();
-        float averaged = (delayLine[writePos] + delayLine[prevPos]) * 0.5f;
+        auto* line = delayLine.data();
+        int pos = writePos;
+        float prev = previousInput;
+        float apIn = allpassInput;
+        float apOut = allpassOutput;
+        const float a = allpassCoefficient;
         
-        // Apply damping
-        averaged *= 0.995f; // Slight decay
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Read from delay line
+            const float delayed = line[(pos - delayLength) & mask];
+            
+            // Karplus-Strong averaging filter
+            const float averaged = (delayed + prev) * 0.5f;
+            prev = delayed;
+            
+            // Fractional delay for tuning
+            const float tuned = a * averaged + apIn - a * apOut;
+            apIn = averaged;
+            apOut = tuned;
+            
+            // Apply damping and write back
+            line[pos] = tuned * 0.995f; // Slight decay
+            pos = (pos + 1) & mask;
+            
+            output[i] = delayed;
+        }
         
-        // Write back
-        delayLine[writePos] = averaged;
+        writePos = pos;
+        previousInput = prev;
+        allpassInput = apIn;
+        allpassOutput = apOut;
         
-        // Advance write position
-        writePos = (writePos + 1) % delayLine.size();
+        JUCE_SNAP_TO_ZERO(allpassInput);
+        JUCE_SNAP_TO_ZERO(allpassOutput);
         
-        return output;
+        // Every value in the loop passes the output within one period
+        const auto range = juce::FloatVectorOperations::findMinAndMax(output, numSamples);
+        if (juce::jmax(-range.getStart(), range.getEnd()) < silenceThreshold)
+            quietSamples = juce::jmin(quietSamples + numSamples, mask + 1);
+        else
+            quietSamples = 0;
+    }
+    
+    // True once a full loop period has come out below -120 dBFS
+    bool isSilent() const
+    {
+        return quietSamples > delayLength + 1;
     }
     
+    static constexpr float silenceThreshold = 1.0e-6f; // -120 dBFS
+    
 private:
-    std::vector<float> delayLine;
+    std::vector<float> delayLine;   // Power-of-two sized, indexed with mask
+    int mask = 0;
     double sampleRate = 44100.0;
     float frequency = 440.0f;
-    float delayLength = 100.0f;
+    int delayLength = 100;
     int writePos = 0;
+    
+    float previousInput = 0.0f;
+    float allpassCoefficient = 0.0f;
+    float allpassInput = 0.0f;
+    float allpassOutput = 0.0f;
+    int quietSamples = 0;
+    
     juce::Random random;
 };
 
@@ -11,6 +11,10 @@
 #include "MacroSystem.h"
 #include "MacroPanel.h"
 #include "BasicOscillator.h"
+#include "ControlRateFilter.h"
+#include "ParallelVoiceRenderer.h"
+#include "ParameterSmoothingBank.h"
+#include "TelemetryChannel.h"
 
 //==============================================================================
 // ULTIMATE PLUCK VOICE - Combines all engines
@@ -44,9 +48,25 @@ public:
     void startNote(int midiNote, float velocity,
                    juce::SynthesiserSound*, int) override
     {
-        frequency = juce::MidiMessage::getMidiNoteInHertz(midiNote);
+        syncParameters();
+        startPitch(midiNote);
         noteVelocity = velocity;
+        startModulation();
         isActive = true;
+        sleeping = false;
+        
+        // Counts as loud until it has rendered, so the other notes of a
+        // chord can't steal it
+        level = 1.0f;
+
+        // Velocity sensitivity: 0 = fixed level, 1 = linear, 2 = exaggerated
+        velocityGain = juce::jlimit(0.0f, 1.0f, 1.0f + params->velocitySens * (velocity - 1.0f));
+
+        // Pan spread places notes across the stereo field by pitch (equal power,
+        // unity at the centre)
+        const float notePosition = juce::jlimit(-1.0f, 1.0f, (midiNote - 60) / 48.0f);
+        notePan = 0.5f + 0.5f * params->panSpread * notePosition;
+        setPan(notePan);
 
         // CRITICAL FIX: Longer fade-in (10ms) to prevent clicks on retrigger and chords
         fadeInSamples = static_cast<int>(sampleRate * 0.010); // 10ms
@@ -56,20 +76,27 @@ public:
         // Trigger all engines
         ModalResonator::ResonatorParams ringParams;
         ringParams.frequency = frequency;
-        ringParams.brightness = params.ringsBrightness;
-        ringParams.damping = params.ringsDamping;
-        ringParams.position = params.ringsPosition;
-        ringParams.structure = params.ringsStructure;
-        ringParams.model = params.ringsModel;
+        ringParams.brightness = params->ringsBrightness;
+        ringParams.damping = params->ringsDamping;
+        ringParams.position = params->ringsPosition;
+        ringParams.structure = params->ringsStructure;
+        ringParams.model = params->ringsModel;
         modalResonator.setParameters(ringParams);
         modalResonator.trigger(velocity);
+        appliedRings = { ringParams.structure, ringParams.brightness, ringParams.damping, ringParams.position };
 
         // Karplus-Strong
         karplusStrong.setFrequency(frequency);
         karplusStrong.trigger(velocity);
 
         // Wavetable oscillator
-        wavetablePhase = 0.0f;
+        wavetableEngine.resetPhase();
+        wavetableEngine.setPhaseIncrement(static_cast<float>(frequency / sampleRate));
+
+        // Oscillators start on pitch; the pitch bus ramps them from here
+        oscillator1.setFrequency(frequency * osc1Ratio);
+        oscillator2.setFrequency(frequency * osc2Ratio);
+        physicalModelFrequency = frequency;
 
         // CRITICAL FIX: Just call noteOn - don't reset envelopes (causes clicks)
         mainEnv.noteOn();
@@ -78,6 +105,15 @@ public:
     
     void stopNote(float, bool allowTailOff) override
     {
+        // Nothing left to fade, the voice can go straight back to the pool
+        if (sleeping)
+        {
+            sleeping = false;
+            isActive = false;
+            clearCurrentNote();
+            return;
+        }
+        
         if (allowTailOff)
         {
             mainEnv.noteOff();
@@ -92,195 +128,72 @@ public:
         }
     }
     
+    // Pitch bend and the mod wheel reach the voice as global modulation
+    // sources (see UltimatePluckSynthesiser)
     void pitchWheelMoved(int) override {}
     void controllerMoved(int, int) override {}
     
+    void aftertouchChanged(int newAftertouchValue) override
+    {
+        polyAftertouch = static_cast<float>(newAftertouchValue) / 127.0f;
+        updateAftertouch();
+    }
+    
+    void channelPressureChanged(int newChannelPressureValue) override
+    {
+        channelPressure = static_cast<float>(newChannelPressureValue) / 127.0f;
+        updateAftertouch();
+    }
+    
     void renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
                         int startSample, int numSamples) override
     {
-        if (!isActive)
+        if (!isActive || sleeping)
             return;
         
-        auto* leftBuffer = outputBuffer.getWritePointer(0, startSample);
-        auto* rightBuffer = outputBuffer.getWritePointer(1, startSample);
+        syncParameters();
+        outputPeak = 0.0f;
+        const int blockLength = numSamples;
         
-        for (int sample = 0; sample < numSamples; ++sample)
+        // Render in chunks that never cross a control tick, so every pitch
+        // ramp runs over exactly controlInterval samples
+        while (numSamples > 0 && isActive)
         {
-            float output = 0.0f;
-            float leftOut = 0.0f;
-            float rightOut = 0.0f;
-            
-            // Calculate oscillator frequencies with pitch adjustments
-            float osc1Freq = frequency * std::pow(2.0f, params.osc1Octave + params.osc1Semi/12.0f + params.osc1Fine/1200.0f);
-            float osc2Freq = frequency * std::pow(2.0f, params.osc2Octave + params.osc2Semi/12.0f + params.osc2Fine/1200.0f);
-
-            oscillator1.setFrequency(osc1Freq);
-            oscillator2.setFrequency(osc2Freq);
-
-            // Generate oscillator samples
-            float osc1Sample = oscillator1.processSample();
-            float osc2Sample = oscillator2.processSample();
-            float oscOutput = (osc1Sample * params.osc1Mix) + (osc2Sample * params.osc2Mix);
-
-            // Generate from selected engines
-            switch (params.engineMode)
+            if (samplesUntilControlTick == 0)
             {
-                case EngineMode::Rings:
-                    output = modalResonator.processSample(0.0f);
-                    leftOut = rightOut = output;
-                    break;
-
-                case EngineMode::Clouds:
-                {
-                    // Feed wavetable into granular
-                    float wavetableSample = generateWavetable();
-                    granularEngine.writeInput(wavetableSample, wavetableSample);
-                    granularEngine.processStereo(leftOut, rightOut);
-                    break;
-                }
-
-                case EngineMode::Karplus:
-                    output = karplusStrong.getSample();
-                    leftOut = rightOut = output;
-                    break;
-
-                case EngineMode::RingsIntoGrains:
-                {
-                    // Rings feeds granular engine
-                    float ringsSample = modalResonator.processSample(0.0f);
-                    granularEngine.writeInput(ringsSample, ringsSample);
-                    granularEngine.processStereo(leftOut, rightOut);
-                    break;
-                }
-
-                case EngineMode::HybridAll:
-                {
-                    // Mix all three original engines
-                    float rings = modalResonator.processSample(0.0f) * params.ringsMix;
-                    float karplus = karplusStrong.getSample() * params.karplusMix;
-                    float wavetable = generateWavetable() * params.wavetableMix;
-
-                    // Feed into granular
-                    float mixed = rings + karplus + wavetable;
-                    granularEngine.writeInput(mixed, mixed);
-
-                    float grainL, grainR;
-                    granularEngine.processStereo(grainL, grainR);
-
-                    leftOut = mixed * (1.0f - params.grainsMix) + grainL * params.grainsMix;
-                    rightOut = mixed * (1.0f - params.grainsMix) + grainR * params.grainsMix;
-                    break;
-                }
-
-                case EngineMode::BasicOscillator:
-                {
-                    // Pure oscillator mode - warm, clean synth
-                    leftOut = rightOut = oscOutput;
-                    break;
-                }
-
-                case EngineMode::OscPlusRings:
-                {
-                    // Oscillator warmth + Rings character
-                    float rings = modalResonator.processSample(0.0f);
-                    leftOut = rightOut = oscOutput + rings * 0.5f;  // 50/50 blend
-                    break;
-                }
-
-                case EngineMode::OscPlusClouds:
-                {
-                    // Oscillator warmth + Clouds texture
-                    granularEngine.writeInput(oscOutput, oscOutput);
-                    granularEngine.processStereo(leftOut, rightOut);
-                    leftOut = oscOutput * 0.5f + leftOut * 0.5f;
-                    rightOut = oscOutput * 0.5f + rightOut * 0.5f;
-                    break;
-                }
-
-                case EngineMode::FullHybrid:
-                {
-                    // Everything: oscillators + all engines
-                    float rings = modalResonator.processSample(0.0f) * params.ringsMix;
-                    float karplus = karplusStrong.getSample() * params.karplusMix;
-                    float wavetable = generateWavetable() * params.wavetableMix;
-
-                    // Mix with oscillators
-                    float engineMix = rings + karplus + wavetable;
-                    float totalMix = oscOutput + engineMix;
-
-                    // Feed into granular
-                    granularEngine.writeInput(totalMix, totalMix);
-
-                    float grainL, grainR;
-                    granularEngine.processStereo(grainL, grainR);
-
-                    leftOut = totalMix * (1.0f - params.grainsMix) + grainL * params.grainsMix;
-                    rightOut = totalMix * (1.0f - params.grainsMix) + grainR * params.grainsMix;
-                    break;
-                }
-
-                case EngineMode::NumModes:
-                    // This case should not be reached
-                    break;
-            }
-            
-            // Apply filter
-            float filtered = filter.processSample(0, leftOut);
-            float filteredR = filter.processSample(1, rightOut);
-            
-            // Apply envelopes
-            float mainEnvValue = mainEnv.getNextSample();
-            float filterEnvValue = filterEnv.getNextSample();
-
-            // Modulate filter
-            updateFilter(filterEnvValue);
-
-            // ANTI-CLICK FADE-IN (1ms)
-            float fadeInGain = 1.0f;
-            if (fadeInCounter < fadeInSamples)
-            {
-                fadeInGain = static_cast<float>(fadeInCounter) / static_cast<float>(fadeInSamples);
-                fadeInCounter++;
-            }
-
-            // ANTI-CLICK FADE-OUT (2ms) - for voice stealing
-            float fadeOutGain = 1.0f;
-            if (isFadingOut)
-            {
-                fadeOutGain = 1.0f - (static_cast<float>(fadeOutCounter) / static_cast<float>(fadeOutSamples));
-                fadeOutCounter++;
-
-                if (fadeOutCounter >= fadeOutSamples)
-                {
-                    // Fade complete - clear note
-                    clearCurrentNote();
-                    isActive = false;
-                    isFadingOut = false;
-                    break;
-                }
+                applyModulation();
+                updatePitch();
+                samplesUntilControlTick = controlInterval;
             }
-
-            // Combine all gain stages with MORE headroom to prevent distortion
-            float totalGain = mainEnvValue * noteVelocity * fadeInGain * fadeOutGain * 0.25f;
-
-            // Final output
-            leftBuffer[sample] += filtered * totalGain;
-            rightBuffer[sample] += filteredR * totalGain;
             
-            // Update wavetable phase
-            wavetablePhase += frequency / sampleRate;
-            if (wavetablePhase >= 1.0f)
-                wavetablePhase -= 1.0f;
+            const int chunkSize = juce::jmin(numSamples, samplesUntilControlTick);
+            renderChunk(outputBuffer, startSample, chunkSize);
             
-            if (!mainEnv.isActive())
-            {
-                clearCurrentNote();
-                isActive = false;
-                break;
-            }
+            samplesUntilControlTick -= chunkSize;
+            startSample += chunkSize;
+            numSamples -= chunkSize;
         }
+        
+        if (isActive)
+            checkForSilence();
+        
+        level = juce::jmax(outputPeak, level * std::exp(-static_cast<float>(blockLength) * levelDecayPerSample));
     }
     
+    // Output peak with a short release, as heard by the listener; sleeping
+    // and finished voices are silent
+    float getLevel() const { return needsRendering() ? level : 0.0f; }
+    
+    // A sleeping voice still holds its note but skips rendering until it is
+    // released or stolen
+    bool isSleeping() const { return sleeping; }
+    
+    // Grain activity, for the editor's visualiser
+    const GranularEngine& getGranularEngine() const { return granularEngine; }
+    
+    // True when the next renderNextBlock() call will produce output
+    bool needsRendering() const { return isActive && !sleeping; }
+    
     // Parameter structure
     struct VoiceParams
     {
@@ -329,57 +242,133 @@ public:
         float decay = 0.3f;
         float sustain = 0.7f;
         float release = 0.5f;
+
+        // Performance
+        float portamento = 0.0f;     // 0-1, glide time portamento^2 * 2 s
+        float vibratoDepth = 0.0f;   // 0-1, up to +-1 semitone
+        float vibratoRate = 4.0f;    // Hz
+        float masterTune = 0.0f;     // Cents
+        float velocitySens = 1.0f;   // 0-2
+        float panSpread = 0.0f;      // 0-1
+        int unisonVoices = 1;        // Oscillator unison stack, 1-4
+        float unisonDetune = 0.0f;   // Cents across the stack
+    };
+    
+    // VoiceParams fields grouped by the state they feed. A section is
+    // compared as a unit and remembers the version in which it last changed.
+    enum ParamSection
+    {
+        envelopeSection,
+        filterSection,
+        ringsSection,
+        cloudsSection,
+        wavetableSection,
+        oscillatorSection,
+        mixSection,
+        performanceSection,
+        numParamSections
+    };
+    
+    // Immutable once published
+    struct ParameterSnapshot
+    {
+        ParameterSnapshot() { sectionVersions.fill(version); }
+        
+        VoiceParams params;
+        juce::uint32 version = 1;
+        std::array<juce::uint32, numParamSections> sectionVersions;
+    };
+    
+    // Double-buffered snapshot store, published on the audio thread once per
+    // block. A block with no parameter changes leaves both buffers untouched.
+    class ParameterPublisher
+    {
+    public:
+        void publish(const VoiceParams& newParams)
+        {
+            const auto& current = snapshots[front];
+            juce::uint32 changedSections = 0;
+            
+            for (int section = 0; section < numParamSections; ++section)
+            {
+                if (!sectionMatches(static_cast<ParamSection>(section), current.params, newParams))
+                    changedSections |= 1u << section;
+            }
+            
+            if (changedSections == 0)
+                return;
+            
+            auto& next = snapshots[1 - front];
+            next.params = newParams;
+            next.version = current.version + 1;
+            
+            for (size_t section = 0; section < numParamSections; ++section)
+            {
+                next.sectionVersions[section] = (changedSections & (1u << section)) != 0 ? next.version
+                                                                                        : current.sectionVersions[section];
+            }
+            
+            front = 1 - front;
+        }
+        
+        const ParameterSnapshot& getSnapshot() const { return snapshots[front]; }
+        
+    private:
+        std::array<ParameterSnapshot, 2> snapshots;
+        size_t front = 0;
     };
     
+    // Points the voice at a shared publisher (nullptr = its own, fed through
+    // setParameters)
+    void setParameterSource(const ParameterPublisher* newSource)
+    {
+        source = newSource != nullptr ? newSource : &ownParameters;
+        appliedVersion = 0;
+        syncParameters();
+    }
+    
+    // For a voice that isn't attached to a shared publisher
     void setParameters(const VoiceParams& p)
     {
-        params = p;
-
-        // Update ADSR
-        juce::ADSR::Parameters adsrParams;
-        adsrParams.attack = p.attack;
-        adsrParams.decay = p.decay;
-        adsrParams.sustain = p.sustain;
-        adsrParams.release = p.release;
-        mainEnv.setParameters(adsrParams);
-
-        juce::ADSR::Parameters filterAdsrParams;
-        filterAdsrParams.attack = p.attack * 0.5f;
-        filterAdsrParams.decay = p.decay * 0.7f;
-        filterAdsrParams.sustain = p.sustain * 0.8f;
-        filterAdsrParams.release = p.release * 0.6f;
-        filterEnv.setParameters(filterAdsrParams);
-
-        // Update granular engine
-        granularEngine.setParameters(p.cloudsParams);
-
-        // Update oscillators
-        oscillator1.setWaveType(p.osc1Wave);
-        oscillator1.setPulseWidth(p.osc1PW);
-        oscillator2.setWaveType(p.osc2Wave);
-        oscillator2.setPulseWidth(p.osc2PW);
+        ownParameters.publish(p);
+        syncParameters();
     }
     
-    void prepare(double sr)
+    // sharedGrainCapture: optional capture buffer shared by all voices,
+    // otherwise the voice allocates its own
+    void prepare(double sr, GranularCaptureBuffer* sharedGrainCapture = nullptr)
     {
         sampleRate = sr;
+        levelDecayPerSample = 1.0f / (levelReleaseSeconds * static_cast<float>(sr));
         mainEnv.setSampleRate(sr);
         filterEnv.setSampleRate(sr);
         modalResonator.setSampleRate(sr);
-        granularEngine.setSampleRate(sr);
-        karplusStrong.setSampleRate(sr);
+        granularEngine.prepare(sr, sharedGrainCapture);
+        karplusStrong.prepare(sr, (float) juce::MidiMessage::getMidiNoteInHertz(0));
 
         // Prepare oscillators
         oscillator1.setSampleRate(sr);
         oscillator2.setSampleRate(sr);
 
         // Prepare filter for stereo processing
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sr;
-        spec.maximumBlockSize = 512;
-        spec.numChannels = 2;
-        filter.prepare(spec);
-        filter.reset();
+        filter.prepare(sr);
+    }
+    
+    // Switches between the voice's own capture buffer and a shared one
+    // (nullptr). Allocates; only call with processing suspended.
+    void setSharedGrainCapture(GranularCaptureBuffer* sharedGrainCapture)
+    {
+        granularEngine.prepare(sampleRate, sharedGrainCapture);
+    }
+    
+    // Gives the voice its own lane of a polyphonic modulation bank (nullptr
+    // = unmodulated). The per-note random source is seeded from the lane,
+    // so the same notes always render the same way.
+    void setModulationLane(VoiceModulationBank* bank, int lane)
+    {
+        modulation = bank;
+        modulationLane = lane;
+        noteRandom.setSeed(lane + 1);
     }
 
 private:
@@ -394,17 +383,73 @@ private:
     BasicOscillator oscillator2;
 
     // Filter and envelopes
-    juce::dsp::StateVariableTPTFilter<float> filter;
+    ControlRateFilter filter;
     juce::ADSR mainEnv;
     juce::ADSR filterEnv;
 
+    // Parameters: params points into the source's current snapshot, and
+    // appliedVersion is the snapshot the derived engine state was built from
+    ParameterPublisher ownParameters;
+    const ParameterPublisher* source = &ownParameters;
+    const VoiceParams* params = &ownParameters.getSnapshot().params;
+    juce::uint32 appliedVersion = 0;
+
     // State
-    VoiceParams params;
     float frequency = 440.0f;
     float noteVelocity = 0.0f;
     double sampleRate = 44100.0;
     bool isActive = false;
-    float wavetablePhase = 0.0f;
+
+    // Pitch bus: glide, vibrato and tuning, evaluated every controlInterval
+    // samples and ramped linearly in between
+    static constexpr int controlInterval = 32;
+    int samplesUntilControlTick = 0;
+    float currentNote = 60.0f;          // Gliding pitch in (fractional) MIDI notes
+    float targetNote = 60.0f;
+    float glideStep = 0.0f;             // Notes per control tick
+    bool hasPlayedNote = false;
+    float vibratoPhase = 0.0f;
+    float osc1Ratio = 1.0f;
+    float osc2Ratio = 1.0f;
+    float physicalModelFrequency = 0.0f; // Last pitch given to Rings/Karplus
+
+    // Silence tracking: a voice whose output and engine state stay below
+    // -120 dBFS for a whole block stops rendering
+    static constexpr float silenceThreshold = 1.0e-6f;
+    float outputPeak = 0.0f;
+    
+    // Peak follower for voice stealing, ~50 ms release
+    static constexpr float levelReleaseSeconds = 0.05f;
+    float level = 0.0f;
+    float levelDecayPerSample = 1.0f / (levelReleaseSeconds * 44100.0f);
+    bool sleeping = false;
+
+    // Per-note gain stages
+    float velocityGain = 1.0f;
+    float notePan = 0.5f;
+    float panLeft = 1.0f;
+    float panRight = 1.0f;
+    
+    // Polyphonic modulation, refreshed every control tick. Every value stays
+    // neutral until something is routed to it.
+    VoiceModulationBank* modulation = nullptr;
+    int modulationLane = 0;
+    juce::Random noteRandom;
+    float polyAftertouch = 0.0f;
+    float channelPressure = 0.0f;
+    float pitchModulation = 0.0f;       // Semitones
+    float detuneRatio = 1.0f;           // Oscillator 2 up and oscillator 1 down by this
+    float cutoffScale = 1.0f;
+    float resonanceScale = 1.0f;
+    float oscLevelScale = 1.0f;
+    float volumeScale = 1.0f;
+    float grainsMixScale = 1.0f;
+    float wavetableMorphOffset = 0.0f;
+    float wavetableWarpOffset = 0.0f;
+    std::array<float, 4> appliedRings {};   // Structure, brightness, damping, position given to the modal bank
+    bool panModulated = false;
+    bool ringsModulated = false;
+    bool cloudsModulated = false;
 
     // Anti-click fade state
     int fadeInCounter = 0;
@@ -413,18 +458,562 @@ private:
     int fadeOutSamples = 0;
     bool isFadingOut = false;
     
-    float generateWavetable()
+    // Per-voice scratch buffers, one channel per engine stage
+    enum ScratchChannel
+    {
+        osc1Channel,
+        osc2Channel,
+        oscMixChannel,
+        ringsChannel,
+        karplusChannel,
+        wavetableChannel,
+        engineMixChannel,
+        grainLeftChannel,
+        grainRightChannel,
+        leftChannel,
+        rightChannel,
+        mainEnvChannel,
+        filterEnvChannel,
+        numScratchChannels
+    };
+    
+    juce::AudioBuffer<float> scratch { numScratchChannels, controlInterval };
+    
+    float getTunedNote(float note) const
+    {
+        return note + params->masterTune / 100.0f;
+    }
+    
+    static float noteToFrequency(float note)
     {
-        return wavetableEngine.getSample(wavetablePhase, params.wavetableParams);
+        return 440.0f * std::exp2((note - 69.0f) / 12.0f);
     }
     
-    void updateFilter(float envValue)
+    void startPitch(int midiNote)
     {
-        float modulated = params.filterCutoff * (1.0f + params.filterEnvAmount * envValue * 10.0f);
+        targetNote = static_cast<float>(midiNote);
+        
+        // Portamento glides from wherever this voice last was, at constant time
+        const float glideTime = params->portamento * params->portamento * 2.0f;
+        const float glideTicks = glideTime * static_cast<float>(sampleRate) / controlInterval;
+        
+        if (hasPlayedNote && glideTicks >= 1.0f)
+            glideStep = (targetNote - currentNote) / glideTicks;
+        else
+            currentNote = targetNote;
+        
+        hasPlayedNote = true;
+        vibratoPhase = 0.0f;
+        samplesUntilControlTick = 0;
+        frequency = noteToFrequency(getTunedNote(currentNote));
+    }
+    
+    // One control tick: advance glide and vibrato, then ramp every engine
+    // towards the new pitch over the next controlInterval samples
+    void updatePitch()
+    {
+        if (currentNote != targetNote)
+        {
+            currentNote += glideStep;
+            
+            // Snap once we reach or pass the target
+            if ((targetNote - currentNote) * glideStep <= 0.0f)
+                currentNote = targetNote;
+        }
+        
+        vibratoPhase += params->vibratoRate * controlInterval / static_cast<float>(sampleRate);
+        if (vibratoPhase >= 1.0f)
+            vibratoPhase -= 1.0f;
+        
+        const float vibrato = params->vibratoDepth * std::sin(vibratoPhase * juce::MathConstants<float>::twoPi);
+        frequency = noteToFrequency(getTunedNote(currentNote) + vibrato + pitchModulation);
+        
+        oscillator1.rampFrequency(frequency * osc1Ratio / detuneRatio, controlInterval);
+        oscillator2.rampFrequency(frequency * osc2Ratio * detuneRatio, controlInterval);
+        wavetableEngine.rampPhaseIncrement(static_cast<float>(frequency / sampleRate), controlInterval);
+        
+        // The physical models retune per tick, and only when the pitch moved
+        // (~0.2 cents), since the modal bank recomputes every mode
+        if (std::abs(frequency - physicalModelFrequency) > physicalModelFrequency * 1.0e-4f)
+        {
+            physicalModelFrequency = frequency;
+            karplusStrong.setFrequency(frequency);
+            modalResonator.setFrequency(frequency);
+        }
+    }
+    
+    void setPan(float pan)
+    {
+        panLeft = juce::MathConstants<float>::sqrt2 * std::cos(pan * juce::MathConstants<float>::halfPi);
+        panRight = juce::MathConstants<float>::sqrt2 * std::sin(pan * juce::MathConstants<float>::halfPi);
+    }
+    
+    // Writes the note's velocity and random value, and starts its envelope
+    // and aftertouch sources from zero (renderChunk() keeps the envelopes
+    // current)
+    void startModulation()
+    {
+        if (modulation == nullptr)
+            return;
+        
+        modulation->setVoiceSource(modulationLane, ModulationSource::Type::Velocity, noteVelocity);
+        modulation->setVoiceSource(modulationLane, ModulationSource::Type::Random, noteRandom.nextFloat() * 2.0f - 1.0f);
+        modulation->setVoiceSource(modulationLane, ModulationSource::Type::Envelope1, 0.0f);
+        modulation->setVoiceSource(modulationLane, ModulationSource::Type::Envelope2, 0.0f);
+        
+        polyAftertouch = 0.0f;
+        updateAftertouch();
+    }
+    
+    // Polyphonic and channel pressure both drive the one aftertouch source
+    void updateAftertouch()
+    {
+        if (modulation != nullptr)
+            modulation->setVoiceSource(modulationLane, ModulationSource::Type::Aftertouch,
+                                       juce::jmax(polyAftertouch, channelPressure));
+    }
+    
+    // One control tick of polyphonic modulation, from this voice's lane as of
+    // the bank's last evaluate(). Sums scale their base value the way
+    // AdvancedModulationMatrix::getModulatedValue does, except for pitch
+    // (12 semitones per unit), detune (50 cents per unit), pan and the
+    // position-like controls, which are offset by the sum since their base
+    // is often zero. Rings and Clouds are only touched while routed, and
+    // once more afterwards to fall back to their base values.
+    void applyModulation()
+    {
+        if (modulation == nullptr)
+            return;
+        
+        using Destination = ModulationDestination::Type;
+        auto sum = [this] (Destination destination) { return modulation->getModulation(modulationLane, destination); };
+        auto scale = [&] (Destination destination) { return juce::jmax(0.0f, 1.0f + sum(destination)); };
+        
+        pitchModulation = sum(Destination::OscillatorPitch) * 12.0f;
+        detuneRatio = std::exp2(sum(Destination::OscillatorDetune) * 25.0f / 1200.0f);
+        cutoffScale = scale(Destination::FilterCutoff);
+        resonanceScale = scale(Destination::FilterResonance);
+        oscLevelScale = scale(Destination::OscillatorLevel);
+        volumeScale = scale(Destination::Volume);
+        grainsMixScale = scale(Destination::CloudsBlend);
+        
+        // The engine's crossfade between its two tables is its morph; warp
+        // moves where in the cycle it reads
+        wavetableMorphOffset = sum(Destination::WavetableMorph);
+        wavetableWarpOffset = sum(Destination::WavetablePosition);
+        
+        const bool panRouted = modulation->isRouted(Destination::Pan);
+        if (panRouted || panModulated)
+        {
+            setPan(juce::jlimit(0.0f, 1.0f, notePan + 0.5f * sum(Destination::Pan)));
+            panModulated = panRouted;
+        }
+        
+        const bool ringsRouted = modulation->isRouted(Destination::RingsStructure) || modulation->isRouted(Destination::RingsBrightness)
+                              || modulation->isRouted(Destination::RingsDamping) || modulation->isRouted(Destination::RingsPosition);
+        if (ringsRouted || ringsModulated)
+        {
+            const std::array<float, 4> rings { juce::jlimit(0.0f, 1.0f, params->ringsStructure * scale(Destination::RingsStructure)),
+                                               juce::jlimit(0.0f, 1.0f, params->ringsBrightness * scale(Destination::RingsBrightness)),
+                                               juce::jlimit(0.0f, 1.0f, params->ringsDamping * scale(Destination::RingsDamping)),
+                                               juce::jlimit(0.0f, 1.0f, params->ringsPosition + sum(Destination::RingsPosition)) };
+            
+            // Every change recomputes the whole modal bank, so small moves wait
+            bool moved = false;
+            for (size_t i = 0; i < rings.size(); ++i)
+                moved = moved || std::abs(rings[i] - appliedRings[i]) > 1.0e-3f;
+            
+            if (moved)
+            {
+                ModalResonator::ResonatorParams ringParams;
+                ringParams.frequency = physicalModelFrequency;
+                ringParams.structure = rings[0];
+                ringParams.brightness = rings[1];
+                ringParams.damping = rings[2];
+                ringParams.position = rings[3];
+                ringParams.model = params->ringsModel;
+                modalResonator.setParameters(ringParams);
+                appliedRings = rings;
+            }
+            
+            ringsModulated = ringsRouted;
+        }
+        
+        const bool cloudsRouted = modulation->isRouted(Destination::GrainDensity) || modulation->isRouted(Destination::GrainSize)
+                               || modulation->isRouted(Destination::GrainPitch) || modulation->isRouted(Destination::GrainPosition)
+                               || modulation->isRouted(Destination::CloudsTexture);
+        if (cloudsRouted || cloudsModulated)
+        {
+            auto cloudsParams = params->cloudsParams;
+            cloudsParams.density = juce::jlimit(0.0f, 1.0f, cloudsParams.density * scale(Destination::GrainDensity));
+            cloudsParams.size = juce::jlimit(0.0f, 1.0f, cloudsParams.size * scale(Destination::GrainSize));
+            cloudsParams.texture = juce::jlimit(0.0f, 1.0f, cloudsParams.texture * scale(Destination::CloudsTexture));
+            cloudsParams.pitch = juce::jlimit(-24.0f, 24.0f, cloudsParams.pitch + sum(Destination::GrainPitch) * 12.0f);
+            cloudsParams.position = juce::jlimit(0.0f, 1.0f, cloudsParams.position + sum(Destination::GrainPosition));
+            granularEngine.setParameters(cloudsParams);
+            cloudsModulated = cloudsRouted;
+        }
+    }
+    
+    static bool usesOscillators(EngineMode mode)
+    {
+        return mode == EngineMode::BasicOscillator || mode == EngineMode::OscPlusRings
+            || mode == EngineMode::OscPlusClouds || mode == EngineMode::FullHybrid;
+    }
+    
+    // Picks the engine path once, fills the scratch buffers block-wise, then
+    // filters the result at control rate and applies the per-sample gains
+    void renderChunk(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+    {
+        auto* left = scratch.getWritePointer(leftChannel);
+        auto* right = scratch.getWritePointer(rightChannel);
+        auto* oscOut = scratch.getWritePointer(oscMixChannel);
+        auto* rings = scratch.getWritePointer(ringsChannel);
+        auto* karplus = scratch.getWritePointer(karplusChannel);
+        auto* wavetable = scratch.getWritePointer(wavetableChannel);
+        auto* engineMix = scratch.getWritePointer(engineMixChannel);
+        auto* grainL = scratch.getWritePointer(grainLeftChannel);
+        auto* grainR = scratch.getWritePointer(grainRightChannel);
+        
+        if (usesOscillators(params->engineMode))
+        {
+            auto* osc1 = scratch.getWritePointer(osc1Channel);
+            auto* osc2 = scratch.getWritePointer(osc2Channel);
+            
+            oscillator1.processBlock(osc1, numSamples);
+            oscillator2.processBlock(osc2, numSamples);
+            
+            const float osc1Gain = params->osc1Mix * oscLevelScale;
+            const float osc2Gain = params->osc2Mix * oscLevelScale;
+            
+            for (int i = 0; i < numSamples; ++i)
+                oscOut[i] = osc1[i] * osc1Gain + osc2[i] * osc2Gain;
+        }
+        
+        const float grainsMix = juce::jmin(1.0f, params->grainsMix * grainsMixScale);
+        
+        auto wavetableParams = params->wavetableParams;
+        wavetableParams.morph = juce::jlimit(0.0f, 1.0f, wavetableParams.morph + wavetableMorphOffset);
+        wavetableParams.warp = juce::jlimit(0.0f, 1.0f, wavetableParams.warp + wavetableWarpOffset);
+        
+        // Generate from selected engines
+        switch (params->engineMode)
+        {
+            case EngineMode::Rings:
+                modalResonator.processBlock(left, numSamples);
+                juce::FloatVectorOperations::copy(right, left, numSamples);
+                break;
+            
+            case EngineMode::Clouds:
+                // Feed wavetable into granular
+                wavetableEngine.processBlock(wavetable, numSamples, wavetableParams);
+                granularEngine.processBlock(wavetable, left, right, numSamples, startSample);
+                break;
+            
+            case EngineMode::Karplus:
+                karplusStrong.processBlock(left, numSamples);
+                juce::FloatVectorOperations::copy(right, left, numSamples);
+                break;
+            
+            case EngineMode::RingsIntoGrains:
+                // Rings feeds granular engine
+                modalResonator.processBlock(rings, numSamples);
+                granularEngine.processBlock(rings, left, right, numSamples, startSample);
+                break;
+            
+            case EngineMode::HybridAll:
+            {
+                // Mix all three original engines, then feed into granular
+                modalResonator.processBlock(rings, numSamples);
+                karplusStrong.processBlock(karplus, numSamples);
+                wavetableEngine.processBlock(wavetable, numSamples, wavetableParams);
+                
+                for (int i = 0; i < numSamples; ++i)
+                    engineMix[i] = rings[i] * params->ringsMix + karplus[i] * params->karplusMix
+                                 + wavetable[i] * params->wavetableMix;
+                
+                granularEngine.processBlock(engineMix, grainL, grainR, numSamples, startSample);
+                
+                const float dryGain = 1.0f - grainsMix;
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    left[i] = engineMix[i] * dryGain + grainL[i] * grainsMix;
+                    right[i] = engineMix[i] * dryGain + grainR[i] * grainsMix;
+                }
+                break;
+            }
+            
+            case EngineMode::BasicOscillator:
+                // Pure oscillator mode - warm, clean synth
+                juce::FloatVectorOperations::copy(left, oscOut, numSamples);
+                juce::FloatVectorOperations::copy(right, oscOut, numSamples);
+                break;
+            
+            case EngineMode::OscPlusRings:
+                // Oscillator warmth + Rings character (50/50 blend)
+                modalResonator.processBlock(rings, numSamples);
+                for (int i = 0; i < numSamples; ++i)
+                    left[i] = right[i] = oscOut[i] + rings[i] * 0.5f;
+                break;
+            
+            case EngineMode::OscPlusClouds:
+                // Oscillator warmth + Clouds texture
+                granularEngine.processBlock(oscOut, grainL, grainR, numSamples, startSample);
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    left[i] = oscOut[i] * 0.5f + grainL[i] * 0.5f;
+                    right[i] = oscOut[i] * 0.5f + grainR[i] * 0.5f;
+                }
+                break;
+            
+            case EngineMode::FullHybrid:
+            {
+                // Everything: oscillators + all engines, then feed into granular
+                modalResonator.processBlock(rings, numSamples);
+                karplusStrong.processBlock(karplus, numSamples);
+                wavetableEngine.processBlock(wavetable, numSamples, wavetableParams);
+                
+                for (int i = 0; i < numSamples; ++i)
+                    engineMix[i] = oscOut[i] + rings[i] * params->ringsMix
+                                 + karplus[i] * params->karplusMix + wavetable[i] * params->wavetableMix;
+                
+                granularEngine.processBlock(engineMix, grainL, grainR, numSamples, startSample);
+                
+                const float dryGain = 1.0f - grainsMix;
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    left[i] = engineMix[i] * dryGain + grainL[i] * grainsMix;
+                    right[i] = engineMix[i] * dryGain + grainR[i] * grainsMix;
+                }
+                break;
+            }
+            
+            case EngineMode::NumModes:
+                // This case should not be reached
+                juce::FloatVectorOperations::clear(left, numSamples);
+                juce::FloatVectorOperations::clear(right, numSamples);
+                break;
+        }
+        
+        // Envelopes for the whole chunk
+        auto* mainEnvValues = scratch.getWritePointer(mainEnvChannel);
+        auto* filterEnvValues = scratch.getWritePointer(filterEnvChannel);
+        
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            mainEnvValues[sample] = mainEnv.getNextSample();
+            filterEnvValues[sample] = filterEnv.getNextSample();
+        }
+        
+        if (modulation != nullptr)
+        {
+            modulation->setVoiceSource(modulationLane, ModulationSource::Type::Envelope1, mainEnvValues[numSamples - 1]);
+            modulation->setVoiceSource(modulationLane, ModulationSource::Type::Envelope2, filterEnvValues[numSamples - 1]);
+        }
+        
+        // Chunks never span a control tick, so the cutoff is evaluated once
+        // here and the filter glides to it across the chunk
+        updateFilter(filterEnvValues[numSamples - 1], numSamples);
+        filter.processBlock(left, right, numSamples);
+        
+        auto* leftBuffer = outputBuffer.getWritePointer(0, startSample);
+        auto* rightBuffer = outputBuffer.getWritePointer(1, startSample);
+        
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            // ANTI-CLICK FADE-IN (1ms)
+            float fadeInGain = 1.0f;
+            if (fadeInCounter < fadeInSamples)
+            {
+                fadeInGain = static_cast<float>(fadeInCounter) / static_cast<float>(fadeInSamples);
+                fadeInCounter++;
+            }
+            
+            // ANTI-CLICK FADE-OUT (2ms) - for voice stealing
+            float fadeOutGain = 1.0f;
+            if (isFadingOut)
+            {
+                fadeOutGain = 1.0f - (static_cast<float>(fadeOutCounter) / static_cast<float>(fadeOutSamples));
+                fadeOutCounter++;
+                
+                if (fadeOutCounter >= fadeOutSamples)
+                {
+                    // Fade complete - clear note
+                    clearCurrentNote();
+                    isActive = false;
+                    isFadingOut = false;
+                    break;
+                }
+            }
+            
+            // Combine all gain stages with MORE headroom to prevent distortion
+            float totalGain = mainEnvValues[sample] * velocityGain * volumeScale * fadeInGain * fadeOutGain * 0.25f;
+            
+            // Final output
+            const float outL = left[sample] * totalGain * panLeft;
+            const float outR = right[sample] * totalGain * panRight;
+            leftBuffer[sample] += outL;
+            rightBuffer[sample] += outR;
+            
+            outputPeak = juce::jmax(outputPeak, std::abs(outL), std::abs(outR));
+        }
+        
+        // Once the envelope has finished the rest of the chunk was silent
+        if (isActive && !mainEnv.isActive())
+        {
+            clearCurrentNote();
+            isActive = false;
+        }
+    }
+    
+    // Only engines that decay on their own can fall silent; oscillators and
+    // the wavetable run for as long as the envelope does
+    bool enginesAreSilent() const
+    {
+        switch (params->engineMode)
+        {
+            case EngineMode::Rings:           return modalResonator.isSilent(silenceThreshold);
+            case EngineMode::Karplus:         return karplusStrong.isSilent();
+            case EngineMode::RingsIntoGrains: return modalResonator.isSilent(silenceThreshold) && granularEngine.isSilent();
+            
+            case EngineMode::Clouds:
+            case EngineMode::HybridAll:
+            case EngineMode::BasicOscillator:
+            case EngineMode::OscPlusRings:
+            case EngineMode::OscPlusClouds:
+            case EngineMode::FullHybrid:
+            case EngineMode::NumModes:
+                break;
+        }
+        
+        return false;
+    }
+    
+    // Released voices are freed outright; held ones go to sleep until their
+    // note ends, since nothing can bring their engines back
+    void checkForSilence()
+    {
+        if (outputPeak >= silenceThreshold || !enginesAreSilent())
+            return;
+        
+        if (isKeyDown() || isSustainPedalDown() || isSostenutoPedalDown())
+        {
+            sleeping = true;
+        }
+        else
+        {
+            clearCurrentNote();
+            isActive = false;
+        }
+    }
+    
+    static bool sectionMatches(ParamSection section, const VoiceParams& a, const VoiceParams& b)
+    {
+        switch (section)
+        {
+            case envelopeSection:
+                return a.attack == b.attack && a.decay == b.decay && a.sustain == b.sustain && a.release == b.release;
+                
+            case filterSection:
+                return a.filterCutoff == b.filterCutoff && a.filterResonance == b.filterResonance
+                    && a.filterEnvAmount == b.filterEnvAmount;
+                
+            case ringsSection:
+                return a.ringsBrightness == b.ringsBrightness && a.ringsDamping == b.ringsDamping
+                    && a.ringsPosition == b.ringsPosition && a.ringsStructure == b.ringsStructure
+                    && a.ringsModel == b.ringsModel;
+                
+            case cloudsSection:
+                return a.cloudsParams.position == b.cloudsParams.position && a.cloudsParams.size == b.cloudsParams.size
+                    && a.cloudsParams.density == b.cloudsParams.density && a.cloudsParams.texture == b.cloudsParams.texture
+                    && a.cloudsParams.pitch == b.cloudsParams.pitch && a.cloudsParams.stereoSpread == b.cloudsParams.stereoSpread
+                    && a.cloudsParams.feedback == b.cloudsParams.feedback && a.cloudsParams.reverb == b.cloudsParams.reverb
+                    && a.cloudsParams.freeze == b.cloudsParams.freeze;
+                
+            case wavetableSection:
+                return a.wavetableParams.tableA == b.wavetableParams.tableA && a.wavetableParams.tableB == b.wavetableParams.tableB
+                    && a.wavetableParams.morph == b.wavetableParams.morph && a.wavetableParams.warp == b.wavetableParams.warp
+                    && a.wavetableParams.fold == b.wavetableParams.fold && a.wavetableParams.formant == b.wavetableParams.formant;
+                
+            case oscillatorSection:
+                return a.osc1Wave == b.osc1Wave && a.osc1Octave == b.osc1Octave && a.osc1Semi == b.osc1Semi
+                    && a.osc1Fine == b.osc1Fine && a.osc1PW == b.osc1PW
+                    && a.osc2Wave == b.osc2Wave && a.osc2Octave == b.osc2Octave && a.osc2Semi == b.osc2Semi
+                    && a.osc2Fine == b.osc2Fine && a.osc2PW == b.osc2PW
+                    && a.unisonVoices == b.unisonVoices && a.unisonDetune == b.unisonDetune;
+                
+            case mixSection:
+                return a.engineMode == b.engineMode && a.ringsMix == b.ringsMix && a.karplusMix == b.karplusMix
+                    && a.wavetableMix == b.wavetableMix && a.grainsMix == b.grainsMix
+                    && a.osc1Mix == b.osc1Mix && a.osc2Mix == b.osc2Mix;
+                
+            case performanceSection:
+                return a.portamento == b.portamento && a.vibratoDepth == b.vibratoDepth && a.vibratoRate == b.vibratoRate
+                    && a.masterTune == b.masterTune && a.velocitySens == b.velocitySens && a.panSpread == b.panSpread;
+                
+            case numParamSections:
+                break;
+        }
+        
+        return true;
+    }
+    
+    // Moves to the source's current snapshot and rebuilds only the engine
+    // state whose section changed since the one applied last. Filter, Rings,
+    // wavetable, mix and performance values are read straight from params->
+    void syncParameters()
+    {
+        const auto& snapshot = source->getSnapshot();
+        params = &snapshot.params;
+        
+        if (snapshot.version == appliedVersion)
+            return;
+        
+        auto hasChanged = [&](ParamSection section) { return snapshot.sectionVersions[section] > appliedVersion; };
+        
+        if (hasChanged(envelopeSection))
+        {
+            juce::ADSR::Parameters adsrParams;
+            adsrParams.attack = params->attack;
+            adsrParams.decay = params->decay;
+            adsrParams.sustain = params->sustain;
+            adsrParams.release = params->release;
+            mainEnv.setParameters(adsrParams);
+            
+            juce::ADSR::Parameters filterAdsrParams;
+            filterAdsrParams.attack = params->attack * 0.5f;
+            filterAdsrParams.decay = params->decay * 0.7f;
+            filterAdsrParams.sustain = params->sustain * 0.8f;
+            filterAdsrParams.release = params->release * 0.6f;
+            filterEnv.setParameters(filterAdsrParams);
+        }
+        
+        if (hasChanged(cloudsSection))
+            granularEngine.setParameters(params->cloudsParams);
+        
+        if (hasChanged(oscillatorSection))
+        {
+            oscillator1.setWaveType(params->osc1Wave);
+            oscillator1.setPulseWidth(params->osc1PW);
+            oscillator1.setUnison(params->unisonVoices, params->unisonDetune);
+            oscillator2.setWaveType(params->osc2Wave);
+            oscillator2.setPulseWidth(params->osc2PW);
+            oscillator2.setUnison(params->unisonVoices, params->unisonDetune);
+            
+            // Oscillator tuning relative to the note
+            osc1Ratio = std::exp2(params->osc1Octave + params->osc1Semi / 12.0f + params->osc1Fine / 1200.0f);
+            osc2Ratio = std::exp2(params->osc2Octave + params->osc2Semi / 12.0f + params->osc2Fine / 1200.0f);
+        }
+        
+        appliedVersion = snapshot.version;
+    }
+    
+    void updateFilter(float envValue, int numSamples)
+    {
+        float modulated = params->filterCutoff * cutoffScale * (1.0f + params->filterEnvAmount * envValue * 10.0f);
         modulated = juce::jlimit(20.0f, 20000.0f, modulated);
         
-        filter.setCutoffFrequency(modulated);
-        filter.setResonance(params.filterResonance);
+        filter.setTarget(modulated, params->filterResonance * resonanceScale, numSamples);
     }
 };
 
@@ -438,22 +1027,196 @@ public:
     bool appliesToChannel(int) override { return true; }
 };
 
+//==============================================================================
+// SYNTHESISER - Optionally renders voices across a worker pool
+//==============================================================================
+class UltimatePluckSynthesiser : public juce::Synthesiser
+{
+public:
+    // Starts the worker pool and gives every voice its own render buffer.
+    // Call while processing is suspended (or from prepareToPlay).
+    void startParallelRendering(int numWorkers, int maxBlockSize, double sampleRate)
+    {
+        voiceBuffers.clear();
+
+        for (int i = 0; i < voices.size(); ++i)
+            voiceBuffers.add(new juce::AudioBuffer<float>(2, maxBlockSize));
+
+        jobVoices.resize(static_cast<size_t>(voices.size()));
+        renderer.start(numWorkers, maxBlockSize, sampleRate);
+    }
+
+    void stopParallelRendering()
+    {
+        renderer.stop();
+        voiceBuffers.clear();
+        jobVoices.clear();
+    }
+
+    bool isRenderingInParallel() const { return renderer.getNumWorkers() > 0; }
+
+    // Like renderNextBlock(), but reads the events in [firstEvent, lastEvent)
+    // straight from the caller's buffer instead of a copy. Events inside the
+    // sub-block are handled before it renders and any stamped past its end
+    // after, the same as renderNextBlock() would.
+    void renderSubBlock(juce::AudioBuffer<float>& outputAudio, juce::MidiBufferIterator firstEvent,
+                        juce::MidiBufferIterator lastEvent, int startSample, int numSamples)
+    {
+        const juce::ScopedLock sl(lock);
+        auto event = firstEvent;
+
+        for (; event != lastEvent && (*event).samplePosition < startSample + numSamples; ++event)
+            handleMidiEvent((*event).getMessage());
+
+        renderVoices(outputAudio, startSample, numSamples);
+
+        for (; event != lastEvent; ++event)
+            handleMidiEvent((*event).getMessage());
+    }
+
+    // Voices attached with setParameterSource() read from here
+    UltimatePluckVoice::ParameterPublisher& getVoiceParameters() { return voiceParameters; }
+
+    // Voice i owns lane i, given with UltimatePluckVoice::setModulationLane()
+    VoiceModulationBank& getVoiceModulation() { return voiceModulation; }
+
+    // The routing the voices are modulated with from the next render on
+    // (nullptr = none). Must stay valid until it's replaced; audio thread.
+    void setModulationRouting(const CompiledModulationRouting* routing) { modulationRouting = routing; }
+
+    // Voices stolen since construction, readable from any thread
+    juce::uint32 getNumVoiceSteals() const { return numVoiceSteals.load(std::memory_order_relaxed); }
+
+protected:
+    // Each sounding voice renders into its own buffer on whichever thread
+    // claims it; the buffers are then summed in voice order, so the output
+    // is bit-identical to rendering the voices one after another
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override
+    {
+        // After this segment's notes have started, so they're modulated from
+        // their first sample
+        if (modulationRouting != nullptr)
+            voiceModulation.evaluate(*modulationRouting, voices.size());
+
+        if (!isRenderingInParallel() || voiceBuffers.size() != voices.size()
+            || startSample + numSamples > voiceBuffers.getFirst()->getNumSamples())
+        {
+            juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+            return;
+        }
+
+        int numJobs = 0;
+
+        for (int i = 0; i < voices.size(); ++i)
+        {
+            if (static_cast<UltimatePluckVoice*>(voices.getUnchecked(i))->needsRendering())
+                jobVoices[static_cast<size_t>(numJobs++)] = i;
+        }
+
+        if (numJobs <= 1)
+        {
+            juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+            return;
+        }
+
+        jobStart = startSample;
+        jobLength = numSamples;
+        renderer.run(numJobs, renderJob, this);
+
+        for (int job = 0; job < numJobs; ++job)
+        {
+            const auto& voiceBuffer = *voiceBuffers.getUnchecked(jobVoices[static_cast<size_t>(job)]);
+
+            for (int channel = 0; channel < juce::jmin(outputAudio.getNumChannels(), 2); ++channel)
+                outputAudio.addFrom(channel, startSample, voiceBuffer, channel, startSample, numSamples);
+        }
+    }
+
+    void handleController(int midiChannel, int controllerNumber, int controllerValue) override
+    {
+        if (controllerNumber == 1)
+            voiceModulation.setGlobalSource(ModulationSource::Type::ModWheel, static_cast<float>(controllerValue) / 127.0f);
+
+        juce::Synthesiser::handleController(midiChannel, controllerNumber, controllerValue);
+    }
+
+    void handlePitchWheel(int midiChannel, int wheelValue) override
+    {
+        voiceModulation.setGlobalSource(ModulationSource::Type::PitchBend, static_cast<float>(wheelValue - 8192) / 8192.0f);
+
+        juce::Synthesiser::handlePitchWheel(midiChannel, wheelValue);
+    }
+
+    // Steals the quietest voice rather than the oldest. Sleeping voices are
+    // silent and go first; released voices count as 6 dB quieter than held
+    // ones, and equal levels fall back to the oldest note.
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay, int, int) const override
+    {
+        UltimatePluckVoice* quietest = nullptr;
+        float quietestScore = 0.0f;
+
+        for (auto* voice : voices)
+        {
+            if (!voice->canPlaySound(soundToPlay))
+                continue;
+
+            auto* pluckVoice = static_cast<UltimatePluckVoice*>(voice);
+            const float score = pluckVoice->isSleeping()           ? -1.0f
+                              : pluckVoice->isPlayingButReleased() ? pluckVoice->getLevel() * 0.5f
+                                                                   : pluckVoice->getLevel();
+
+            if (quietest == nullptr || score < quietestScore
+                || (score == quietestScore && pluckVoice->wasStartedBefore(*quietest)))
+            {
+                quietest = pluckVoice;
+                quietestScore = score;
+            }
+        }
+
+        if (quietest != nullptr)
+            numVoiceSteals.fetch_add(1, std::memory_order_relaxed);
+
+        return quietest;
+    }
+
+private:
+    static void renderJob(void* context, int job)
+    {
+        auto& synth = *static_cast<UltimatePluckSynthesiser*>(context);
+        const int voiceIndex = synth.jobVoices[static_cast<size_t>(job)];
+        auto& voiceBuffer = *synth.voiceBuffers.getUnchecked(voiceIndex);
+
+        voiceBuffer.clear(synth.jobStart, synth.jobLength);
+        synth.voices.getUnchecked(voiceIndex)->renderNextBlock(voiceBuffer, synth.jobStart, synth.jobLength);
+    }
+
+    UltimatePluckVoice::ParameterPublisher voiceParameters;
+    VoiceModulationBank voiceModulation;
+    const CompiledModulationRouting* modulationRouting = nullptr;
+    mutable std::atomic<juce::uint32> numVoiceSteals { 0 };
+    ParallelVoiceRenderer renderer;
+    juce::OwnedArray<juce::AudioBuffer<float>> voiceBuffers;
+    std::vector<int> jobVoices;
+    int jobStart = 0;
+    int jobLength = 0;
+};
+
 //==============================================================================
 // ULTIMATE PLUCK PROCESSOR
 //==============================================================================
-class UltimatePluckProcessor : public juce::AudioProcessor
+class UltimatePluckProcessor : public juce::AudioProcessor,
+                               private juce::AudioProcessorValueTreeState::Listener,
+                               private juce::AsyncUpdater
 {
 public:
     UltimatePluckProcessor()
         : AudioProcessor(BusesProperties()
                         .withOutput("Output", juce::AudioChannelSet::stereo(), true))
     {
-        // PERFORMANCE: Reduced from 16 to 8 voices to improve CPU usage
-        // Modal synthesis is CPU-intensive, 8 voices is sufficient for most use cases
-        for (int i = 0; i < 8; ++i)
-        {
-            synth.addVoice(new UltimatePluckVoice());
-        }
+        // Starts at the default polyphony; setPolyphony() or a saved state
+        // can change it
+        for (int i = 0; i < defaultPolyphony; ++i)
+            addPluckVoice();
 
         synth.addSound(new SimpleSynthSound());
         
@@ -472,6 +1235,15 @@ public:
 
         // Create LFO section
         lfoSection = std::make_unique<LFOSection>(*apvts);
+
+        // The oversampling factor sets the distortion's latency, so it is
+        // applied on the message thread rather than per block
+        apvts->addParameterListener("distortionOversampling", this);
+    }
+
+    ~UltimatePluckProcessor() override
+    {
+        apvts->removeParameterListener("distortionOversampling", this);
     }
     
     //==============================================================================
@@ -483,10 +1255,22 @@ public:
         {
             if (auto* voice = dynamic_cast<UltimatePluckVoice*>(synth.getVoice(i)))
             {
-                voice->prepare(sampleRate);
+                voice->prepare(sampleRate, sharedGranularCapture ? &sharedGrainCapture : nullptr);
             }
         }
-        
+
+        resetGrainTelemetry();
+
+        if (sharedGranularCapture)
+            sharedGrainCapture.prepare(sampleRate);
+        else
+            sharedGrainCapture.release();
+
+        if (parallelVoiceRendering)
+            synth.startParallelRendering(getNumRenderWorkers(), samplesPerBlock, sampleRate);
+        else
+            synth.stopParallelRendering();
+
         // Prepare effects
         juce::dsp::ProcessSpec spec;
         spec.sampleRate = sampleRate;
@@ -497,18 +1281,25 @@ public:
         delay.prepare(spec);
 
         // Prepare advanced effects
-        advancedDistortion.prepare(sampleRate);
+        advancedDistortion.prepare(sampleRate, maxSubBlockSize); // effects run per sub-block
+        advancedDistortion.setOversampling(static_cast<int>(apvts->getRawParameterValue("distortionOversampling")->load()));
+        setLatencySamples(advancedDistortion.getLatencyInSamples());
         advancedDelay.prepare(sampleRate, 2000); // 2 second max delay
         enhancedReverb.prepare(sampleRate);
+        for (size_t i = 0; i < fdnReverbs.size(); ++i)
+        {
+            fdnReverbs[i].prepare(sampleRate);
+            fdnReverbs[i].setNumLines(i == 0 ? 8 : 16);
+        }
+
+        reverbRingingOut.fill(false);
         chorus.prepare(sampleRate);
 
         // Prepare visual feedback
-        if (visualFeedbackPanel)
-            visualFeedbackPanel->prepare(sampleRate);
 
         // Prepare LFOs
         if (lfoSection)
-            lfoSection->prepare(sampleRate);
+            lfoSection->prepare(sampleRate, samplesPerBlock);
 
         // =====================================================================
         // CACHE ALL PARAMETER POINTERS - REAL-TIME SAFETY CRITICAL
@@ -573,6 +1364,9 @@ public:
         osc2MixParam = apvts->getRawParameterValue("osc2Mix");
 
         // Effect parameters
+        distortionDriveParam = apvts->getRawParameterValue("distortionDrive");
+        distortionModeParam = apvts->getRawParameterValue("distortionMode");
+        distortionMixParam = apvts->getRawParameterValue("distortionMix");
         delayTimeParam = apvts->getRawParameterValue("delayTime");
         delayFeedbackParam = apvts->getRawParameterValue("delayFeedback");
         delayMixParam = apvts->getRawParameterValue("delayMix");
@@ -583,6 +1377,7 @@ public:
         reverbWidthParam = apvts->getRawParameterValue("reverbWidth");
         reverbMixParam = apvts->getRawParameterValue("reverbMix");
         reverbShimmerParam = apvts->getRawParameterValue("reverbShimmer");
+        reverbModeParam = apvts->getRawParameterValue("reverbMode");
         chorusRateParam = apvts->getRawParameterValue("chorusRate");
         chorusDepthParam = apvts->getRawParameterValue("chorusDepth");
         chorusMixParam = apvts->getRawParameterValue("chorusMix");
@@ -599,6 +1394,15 @@ public:
         unisonVoicesParam = apvts->getRawParameterValue("unisonVoices");
         unisonDetuneParam = apvts->getRawParameterValue("unisonDetune");
 
+        // Continuous parameters glide through the smoothing bank, starting
+        // from their current values
+        bindSmoothedParameters();
+        smoothedParameters.prepare(sampleRate);
+
+        // Display snapshots for the editor, telemetryRateHz times a second
+        telemetryInterval = juce::jmax(1, juce::roundToInt(sampleRate / telemetryRateHz));
+        samplesSinceTelemetry = 0;
+
         // REAL-TIME SAFETY: Move factory preset creation to message thread
         // This prevents string operations on audio thread
         if (presetManager)
@@ -611,49 +1415,46 @@ public:
         }
     }
     
-    void releaseResources() override {}
+    void releaseResources() override
+    {
+        synth.stopParallelRendering();
+    }
     
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override
     {
+        // Decaying resonator, filter and reverb tails must not go denormal
+        juce::ScopedNoDenormals noDenormals;
+
         buffer.clear();
 
-        // Process LFOs
+        // One routing for the whole block. Only the LFOs it reads are
+        // rendered, at control rate; renderSubBlocks() hands their values on.
+        const auto& modulationRouting = modulationMatrix.acquireRouting();
+
         if (lfoSection)
-            lfoSection->processBlock(buffer.getNumSamples());
+            lfoSection->processBlock(buffer.getNumSamples(), { modulationRouting.usesSource(ModulationSource::Type::LFO1),
+                                                               modulationRouting.usesSource(ModulationSource::Type::LFO2),
+                                                               modulationRouting.usesSource(ModulationSource::Type::LFO3) });
 
-        // Update modulation sources
-        modulationMatrix.setSourceValue(ModulationSource::Type::LFO1, getLFOValue(0));
-        modulationMatrix.setSourceValue(ModulationSource::Type::LFO2, getLFOValue(1));
-        modulationMatrix.setSourceValue(ModulationSource::Type::LFO3, getLFOValue(2));
+        // The voices modulate themselves, with their own envelopes, velocity
+        // and aftertouch on top of the LFOs
+        synth.setModulationRouting(&modulationRouting);
 
+        smoothedParameters.updateTargets();
         updateVoiceParameters();
 
         // Process keyboard state and add messages to MIDI buffer
         keyboardState.processNextMidiBuffer(midiMessages, 0, buffer.getNumSamples(), true);
 
-        synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
-
-        // Update visual feedback - REAL-TIME SAFE: Move string operations to message thread
-        if (visualFeedbackPanel && cloudsDensityParam && cloudsSizeParam && cloudsPositionParam && cloudsTextureParam)
-        {
-            float density = cloudsDensityParam->load();
-            float grainSize = cloudsSizeParam->load();
-            float position = cloudsPositionParam->load();
-            float texture = cloudsTextureParam->load();
-
-            // Move grain parameter update to message thread to avoid string operations on audio thread
-            juce::MessageManager::callAsync([this, density, grainSize, position, texture]()
-            {
-                if (visualFeedbackPanel)
-                    visualFeedbackPanel->updateGrainParameters(density, grainSize, position, texture);
-            });
-
-            // Push samples to spectrum analyzer - THIS IS REAL-TIME SAFE
-            if (buffer.getNumChannels() > 0)
-                visualFeedbackPanel->pushSamplesForSpectrum(buffer.getReadPointer(0), buffer.getNumSamples());
-        }
+        // No-ops unless the voices share one granular capture buffer. Freeze
+        // holds it here, since the voices only stop summing into it.
+        sharedGrainCapture.setFrozen(blockVoiceParams.cloudsParams.freeze);
+        sharedGrainCapture.beginSharedBlock(buffer.getNumSamples());
+        renderSubBlocks(buffer, midiMessages, modulationRouting);
+        sharedGrainCapture.endSharedBlock(buffer.getNumSamples());
 
-        applyEffects(buffer);
+        updateVoiceCounts();
+        publishTelemetry(buffer);
     }
 
     //==============================================================================
@@ -693,8 +1494,71 @@ public:
     {
         std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
         if (xmlState && xmlState->hasTagName(apvts->state.getType()))
+        {
             apvts->replaceState(juce::ValueTree::fromXml(*xmlState));
+            applyGranularCaptureMode();
+            applyVoiceRenderingMode();
+            applyPolyphony();
+            trueStereoReverb.store(static_cast<bool>(apvts->state.getProperty("trueStereoReverb", false)), std::memory_order_relaxed);
+        }
+    }
+    
+    // When enabled, all voices' granular engines capture into and read from a
+    // single processor-owned buffer instead of allocating one each. Stored in
+    // the plugin state; call from the message thread.
+    void setSharedGranularCapture(bool shouldShare)
+    {
+        apvts->state.setProperty("sharedGranularCapture", shouldShare, nullptr);
+        applyGranularCaptureMode();
+    }
+
+    bool isSharedGranularCapture() const { return sharedGranularCapture; }
+
+    // When enabled, sounding voices are rendered on a pool of real-time worker
+    // threads as well as the audio thread. Has no effect while the granular
+    // capture is shared, since all voices write to it. Stored in the plugin
+    // state; call from the message thread.
+    void setParallelVoiceRendering(bool shouldRenderInParallel)
+    {
+        apvts->state.setProperty("parallelVoiceRendering", shouldRenderInParallel, nullptr);
+        applyVoiceRenderingMode();
+    }
+
+    bool isParallelVoiceRendering() const { return parallelVoiceRendering; }
+
+    // Runs the reverb as Freeverb's true-stereo pair of comb banks instead of
+    // one mono bank panned by width. Stored in the plugin state; the audio
+    // thread picks it up on the next block.
+    void setTrueStereoReverb(bool shouldBeTrueStereo)
+    {
+        apvts->state.setProperty("trueStereoReverb", shouldBeTrueStereo, nullptr);
+        trueStereoReverb.store(shouldBeTrueStereo, std::memory_order_relaxed);
     }
+
+    bool isTrueStereoReverb() const { return trueStereoReverb.load(std::memory_order_relaxed); }
+
+    // Number of voices, 1 to maxPolyphony. Every voice is allocated up front,
+    // with processing suspended. Each voice owns a 4 second granular capture
+    // buffer unless the capture is shared, so share it for large counts.
+    // Stored in the plugin state; call from the message thread.
+    static constexpr int defaultPolyphony = 8;
+    static constexpr int maxPolyphony = 64;
+    static_assert(maxPolyphony <= VoiceModulationBank::maxVoices, "every voice needs a modulation lane");
+
+    void setPolyphony(int numVoices)
+    {
+        apvts->state.setProperty("polyphony", juce::jlimit(1, maxPolyphony, numVoices), nullptr);
+        applyPolyphony();
+    }
+
+    int getPolyphony() const { return synth.getNumVoices(); }
+
+    // Notes that had to take over a sounding voice
+    juce::uint32 getNumVoiceSteals() const { return synth.getNumVoiceSteals(); }
+
+    // Voice activity as of the last processed block, readable from any thread
+    int getNumRenderingVoices() const { return numRenderingVoices.load(std::memory_order_relaxed); }
+    int getNumSleepingVoices() const { return numSleepingVoices.load(std::memory_order_relaxed); }
     
     juce::AudioProcessorValueTreeState& getAPVTS() { return *apvts; }
     PresetManager& getPresetManager() { return *presetManager; }
@@ -778,36 +1642,501 @@ public:
     std::unique_ptr<LFOSection> lfoSection;
     AdvancedModulationMatrix modulationMatrix;
 
-    // Visual Feedback
-    VisualFeedbackPanel* visualFeedbackPanel = nullptr;
-
-    void setVisualFeedbackPanel(VisualFeedbackPanel* panel)
-    {
-        visualFeedbackPanel = panel;
-    }
+    // Visual Feedback: the editor attaches to this and drains it on a timer
+    TelemetryChannel& getTelemetry() { return telemetry; }
 
     // Advanced Effects
     AdvancedDistortion advancedDistortion;
     AdvancedDelay advancedDelay;
     EnhancedReverb enhancedReverb;
+    std::array<FDNReverb, 2> fdnReverbs; // 8 and 16 lines, so either can ring out while the other plays
+    int lastReverbMode = 0;
+
+    // Engines left by a reverb mode switch, by mode. They run on silence
+    // until their tail dies away instead of being cut off.
+    static constexpr int numReverbModes = 3;
+    static constexpr float reverbTailThreshold = 1.0e-5f; // -100 dB
+    std::array<bool, numReverbModes> reverbRingingOut {};
     ChorusEffect chorus;
 
     // Macro System
     MacroSystem macroSystem;
 
-    // Helper to get LFO values for modulation
-    float getLFOValue(int lfoIndex)
+    // An LFO's control-rate value at a sample of the current block
+    float getLFOValue(int lfoIndex, int sample) const
+    {
+        if (lfoSection && lfoIndex >= 0 && lfoIndex < LFOSection::numLFOs)
+            return lfoSection->getValue(lfoIndex, sample);
+
+        return 0.0f;
+    }
+
+private:
+    UltimatePluckSynthesiser synth;
+
+    // Sample-accurate scheduling: the synth renders in sub-blocks that
+    // start at every MIDI event and never run longer than maxSubBlockSize,
+    // with the ramped voice parameters republished for each one
+    static constexpr int maxSubBlockSize = 32;
+
+    // Continuous parameters, by smoothing bank slot. They glide over a fixed
+    // time whatever the host block size; discrete ones still step.
+    enum SmoothedParameter
+    {
+        smoothedFilterCutoff,
+        smoothedFilterResonance,
+        smoothedFilterEnv,
+        smoothedRingsBrightness,
+        smoothedRingsDamping,
+        smoothedRingsPosition,
+        smoothedRingsStructure,
+        smoothedCloudsPosition,
+        smoothedCloudsSize,
+        smoothedCloudsDensity,
+        smoothedCloudsTexture,
+        smoothedCloudsPitch,
+        smoothedCloudsStereo,
+        smoothedWavetableMorph,
+        smoothedWavetableWarp,
+        smoothedWavetableFold,
+        smoothedRingsMix,
+        smoothedKarplusMix,
+        smoothedWavetableMix,
+        smoothedGrainsMix,
+        smoothedOsc1Mix,
+        smoothedOsc2Mix,
+        smoothedVibratoDepth,
+        smoothedDistortionDrive,
+        smoothedDistortionMix,
+        smoothedDelayTime,
+        smoothedDelayFeedback,
+        smoothedDelayMix,
+        smoothedDelayFilter,
+        smoothedReverbSize,
+        smoothedReverbDamping,
+        smoothedReverbWidth,
+        smoothedReverbMix,
+        smoothedReverbShimmer,
+        smoothedChorusRate,
+        smoothedChorusDepth,
+        smoothedChorusMix,
+        smoothedChorusFeedback,
+        smoothedChorusWidth,
+        numSmoothedParameters
+    };
+
+    static_assert(numSmoothedParameters <= ParameterSmoothingBank::maxParameters, "Smoothing bank is too small");
+
+    ParameterSmoothingBank smoothedParameters;
+
+    // Needs the cached parameter pointers
+    void bindSmoothedParameters()
+    {
+        using Scale = ParameterSmoothingBank::Scale;
+        auto& bank = smoothedParameters;
+
+        bank.setParameter(smoothedFilterCutoff, filterCutoffParam, 0.02f, Scale::Logarithmic);
+        bank.setParameter(smoothedFilterResonance, filterResonanceParam);
+        bank.setParameter(smoothedFilterEnv, filterEnvParam);
+        bank.setParameter(smoothedRingsBrightness, ringsBrightnessParam);
+        bank.setParameter(smoothedRingsDamping, ringsDampingParam);
+        bank.setParameter(smoothedRingsPosition, ringsPositionParam);
+        bank.setParameter(smoothedRingsStructure, ringsStructureParam);
+        bank.setParameter(smoothedCloudsPosition, cloudsPositionParam);
+        bank.setParameter(smoothedCloudsSize, cloudsSizeParam);
+        bank.setParameter(smoothedCloudsDensity, cloudsDensityParam);
+        bank.setParameter(smoothedCloudsTexture, cloudsTextureParam);
+        bank.setParameter(smoothedCloudsPitch, cloudsPitchParam);
+        bank.setParameter(smoothedCloudsStereo, cloudsStereoParam);
+        bank.setParameter(smoothedWavetableMorph, wavetableMorphParam);
+        bank.setParameter(smoothedWavetableWarp, wavetableWarpParam);
+        bank.setParameter(smoothedWavetableFold, wavetableFoldParam);
+        bank.setParameter(smoothedRingsMix, ringsMixParam);
+        bank.setParameter(smoothedKarplusMix, karplusMixParam);
+        bank.setParameter(smoothedWavetableMix, wavetableMixParam);
+        bank.setParameter(smoothedGrainsMix, grainsMixParam);
+        bank.setParameter(smoothedOsc1Mix, osc1MixParam);
+        bank.setParameter(smoothedOsc2Mix, osc2MixParam);
+        bank.setParameter(smoothedVibratoDepth, vibratoDepthParam);
+
+        bank.setParameter(smoothedDistortionDrive, distortionDriveParam);
+        bank.setParameter(smoothedDistortionMix, distortionMixParam);
+
+        // Delay time glides slower, since it bends the pitch of the repeats
+        bank.setParameter(smoothedDelayTime, delayTimeParam, 0.1f);
+        bank.setParameter(smoothedDelayFeedback, delayFeedbackParam);
+        bank.setParameter(smoothedDelayMix, delayMixParam);
+        bank.setParameter(smoothedDelayFilter, delayFilterParam, 0.02f, Scale::Logarithmic);
+        bank.setParameter(smoothedReverbSize, reverbSizeParam);
+        bank.setParameter(smoothedReverbDamping, reverbDampingParam);
+        bank.setParameter(smoothedReverbWidth, reverbWidthParam);
+        bank.setParameter(smoothedReverbMix, reverbMixParam);
+        bank.setParameter(smoothedReverbShimmer, reverbShimmerParam);
+        bank.setParameter(smoothedChorusRate, chorusRateParam);
+        bank.setParameter(smoothedChorusDepth, chorusDepthParam);
+        bank.setParameter(smoothedChorusMix, chorusMixParam);
+        bank.setParameter(smoothedChorusFeedback, chorusFeedbackParam);
+        bank.setParameter(smoothedChorusWidth, chorusWidthParam);
+    }
+
+    UltimatePluckVoice::VoiceParams blockVoiceParams;
+    bool hasVoiceParameters = false;
+
+    // Splits the block at each MIDI event and at least every maxSubBlockSize
+    // samples. Each sub-block gets only its own range of events, which the
+    // synth then handles at the sub-block's first sample, so note timing and parameter
+    // ramps come out the same at any host block size. The smoothing bank
+    // advances once per sub-block, and the voices and effects read the
+    // values it reached. The LFOs are read at each sub-block's start.
+    void renderSubBlocks(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages,
+                         const CompiledModulationRouting& modulationRouting)
+    {
+        const int numSamples = buffer.getNumSamples();
+        auto firstEvent = midiMessages.cbegin();
+
+        for (int start = 0; start < numSamples;)
+        {
+            int end = juce::jmin(numSamples, start + maxSubBlockSize);
+
+            const auto nextEvent = midiMessages.findNextSamplePosition(start + 1);
+            if (nextEvent != midiMessages.cend())
+                end = juce::jmin(end, (*nextEvent).samplePosition);
+
+            // The last sub-block also takes any events stamped past the end
+            const auto lastEvent = end < numSamples ? midiMessages.findNextSamplePosition(end) : midiMessages.cend();
+
+            smoothedParameters.advance(end - start);
+            publishVoiceParameters();
+            updateModulationSources(modulationRouting, start);
+            synth.renderSubBlock(buffer, firstEvent, lastEvent, start, end - start);
+            applyEffects(buffer, start, end - start);
+
+            firstEvent = lastEvent;
+            start = end;
+        }
+    }
+
+    // Hands the routed LFOs' values at sample to the matrix and the voices,
+    // then sums the matrix for the sub-block
+    void updateModulationSources(const CompiledModulationRouting& modulationRouting, int sample)
+    {
+        auto& voiceModulation = synth.getVoiceModulation();
+
+        for (int i = 0; i < LFOSection::numLFOs; ++i)
+        {
+            const auto source = static_cast<ModulationSource::Type>(static_cast<int>(ModulationSource::Type::LFO1) + i);
+
+            if (!modulationRouting.usesSource(source))
+                continue;
+
+            const float value = getLFOValue(i, sample);
+            modulationMatrix.setSourceValue(source, value);
+            voiceModulation.setGlobalSource(source, value);
+        }
+
+        modulationMatrix.evaluate(modulationRouting);
+    }
+
+    void publishVoiceParameters()
+    {
+        if (!hasVoiceParameters)
+            return;
+
+        const auto& bank = smoothedParameters;
+        auto voiceParams = blockVoiceParams;
+
+        voiceParams.filterCutoff = bank.get(smoothedFilterCutoff);
+        voiceParams.filterResonance = bank.get(smoothedFilterResonance);
+        voiceParams.filterEnvAmount = bank.get(smoothedFilterEnv);
+        voiceParams.ringsBrightness = bank.get(smoothedRingsBrightness);
+        voiceParams.ringsDamping = bank.get(smoothedRingsDamping);
+        voiceParams.ringsPosition = bank.get(smoothedRingsPosition);
+        voiceParams.ringsStructure = bank.get(smoothedRingsStructure);
+        voiceParams.cloudsParams.position = bank.get(smoothedCloudsPosition);
+        voiceParams.cloudsParams.size = bank.get(smoothedCloudsSize);
+        voiceParams.cloudsParams.density = bank.get(smoothedCloudsDensity);
+        voiceParams.cloudsParams.texture = bank.get(smoothedCloudsTexture);
+        voiceParams.cloudsParams.pitch = bank.get(smoothedCloudsPitch);
+        voiceParams.cloudsParams.stereoSpread = bank.get(smoothedCloudsStereo);
+        voiceParams.wavetableParams.morph = bank.get(smoothedWavetableMorph);
+        voiceParams.wavetableParams.warp = bank.get(smoothedWavetableWarp);
+        voiceParams.wavetableParams.fold = bank.get(smoothedWavetableFold);
+        voiceParams.ringsMix = bank.get(smoothedRingsMix);
+        voiceParams.karplusMix = bank.get(smoothedKarplusMix);
+        voiceParams.wavetableMix = bank.get(smoothedWavetableMix);
+        voiceParams.grainsMix = bank.get(smoothedGrainsMix);
+        voiceParams.osc1Mix = bank.get(smoothedOsc1Mix);
+        voiceParams.osc2Mix = bank.get(smoothedOsc2Mix);
+        voiceParams.vibratoDepth = bank.get(smoothedVibratoDepth);
+
+        // Voices pick the new snapshot up when they next render; nothing is
+        // published if no section changed
+        synth.getVoiceParameters().publish(voiceParams);
+    }
+
+    GranularCaptureBuffer sharedGrainCapture;
+    bool sharedGranularCapture = false;
+    bool parallelVoiceRendering = false;
+    std::atomic<bool> trueStereoReverb { false };
+
+    std::atomic<int> numRenderingVoices { 0 };
+    std::atomic<int> numSleepingVoices { 0 };
+
+    // Display snapshots go out at this rate; output samples every block
+    static constexpr double telemetryRateHz = 60.0;
+    TelemetryChannel telemetry;
+    int telemetryInterval = 735;
+    int samplesSinceTelemetry = 0;
+    std::array<juce::uint32, maxPolyphony> publishedGrainCounts {};
+
+    // Lines each slot's published grain count up with its voice, so the next
+    // snapshot only reports grains spawned from here on. Call with processing
+    // suspended whenever voices are added, removed or re-prepared: a new
+    // voice counts from zero, and a stale count would wrap.
+    void resetGrainTelemetry()
+    {
+        publishedGrainCounts.fill(0);
+
+        for (int i = 0; i < synth.getNumVoices(); ++i)
+            publishedGrainCounts[(size_t) i] = static_cast<UltimatePluckVoice*>(synth.getVoice(i))->getGranularEngine().getNumGrainsSpawned();
+    }
+
+    void publishTelemetry(const juce::AudioBuffer<float>& buffer)
     {
+        if (!telemetry.isConsumerAttached())
+            return;
+
+        const int numSamples = buffer.getNumSamples();
+        telemetry.pushSamples(buffer.getReadPointer(0), buffer.getReadPointer(buffer.getNumChannels() > 1 ? 1 : 0), numSamples);
+
+        samplesSinceTelemetry += numSamples;
+
+        if (samplesSinceTelemetry < telemetryInterval)
+            return;
+
+        samplesSinceTelemetry = 0;
+
+        TelemetryEvent grainParameters;
+        grainParameters.type = TelemetryEvent::Type::grainParameters;
+        grainParameters.values = { cloudsDensityParam->load(), cloudsSizeParam->load(),
+                                   cloudsPositionParam->load(), cloudsTextureParam->load() };
+        telemetry.pushEvent(grainParameters);
+
+        for (int i = 0; i < synth.getNumVoices(); ++i)
+        {
+            auto* voice = static_cast<UltimatePluckVoice*>(synth.getVoice(i));
+
+            // One event per voice stands for every grain it spawned since the
+            // last snapshot
+            const auto& grains = voice->getGranularEngine();
+            const juce::uint32 numSpawned = grains.getNumGrainsSpawned() - publishedGrainCounts[(size_t) i];
+
+            if (numSpawned > 0)
+            {
+                const auto& spawn = grains.getLastSpawn();
+
+                TelemetryEvent grainSpawn;
+                grainSpawn.type = TelemetryEvent::Type::grainSpawn;
+                grainSpawn.index = (juce::uint8) i;
+                grainSpawn.count = (juce::uint16) juce::jmin(numSpawned, (juce::uint32) 0xffff);
+                grainSpawn.values = { spawn.position, spawn.amplitude, spawn.pitch, spawn.size };
+                telemetry.pushEvent(grainSpawn);
+
+                publishedGrainCounts[(size_t) i] = grains.getNumGrainsSpawned();
+            }
+
+            TelemetryEvent voiceLevel;
+            voiceLevel.type = TelemetryEvent::Type::voiceLevel;
+            voiceLevel.index = (juce::uint8) i;
+            voiceLevel.values = { voice->getLevel(), (float) voice->getCurrentlyPlayingNote(), 0.0f, 0.0f };
+            telemetry.pushEvent(voiceLevel);
+        }
+
         if (lfoSection)
         {
-            if (auto* lfo = lfoSection->getLFO(lfoIndex))
-                return lfo->getCurrentValue();
+            for (int i = 0; i < 3; ++i)
+            {
+                if (auto* lfo = lfoSection->getLFO(i))
+                {
+                    TelemetryEvent lfoPhase;
+                    lfoPhase.type = TelemetryEvent::Type::lfoPhase;
+                    lfoPhase.index = (juce::uint8) i;
+                    lfoPhase.values = { lfo->getCurrentPhase(), lfo->getCurrentValue(), 0.0f, 0.0f };
+                    telemetry.pushEvent(lfoPhase);
+                }
+            }
         }
-        return 0.0f;
     }
 
-private:
-    juce::Synthesiser synth;
+    void updateVoiceCounts()
+    {
+        int rendering = 0, sleeping = 0;
+
+        for (int i = 0; i < synth.getNumVoices(); ++i)
+        {
+            if (auto* voice = dynamic_cast<UltimatePluckVoice*>(synth.getVoice(i)))
+            {
+                if (voice->isSleeping())
+                    ++sleeping;
+                else if (voice->isVoiceActive())
+                    ++rendering;
+            }
+        }
+
+        numRenderingVoices.store(rendering, std::memory_order_relaxed);
+        numSleepingVoices.store(sleeping, std::memory_order_relaxed);
+    }
+
+    // Re-points the voices' capture buffers if the stored mode changed. The
+    // buffers are (re)allocated with processing suspended.
+    void applyGranularCaptureMode()
+    {
+        const bool shouldShare = apvts->state.getProperty("sharedGranularCapture", false);
+
+        if (shouldShare == sharedGranularCapture)
+            return;
+
+        const double sampleRate = getSampleRate();
+
+        if (sampleRate <= 0.0)
+        {
+            // Not prepared yet, prepareToPlay allocates for the new mode
+            sharedGranularCapture = shouldShare;
+            applyVoiceRenderingMode();
+            return;
+        }
+
+        suspendProcessing(true);
+
+        sharedGranularCapture = shouldShare;
+
+        if (sharedGranularCapture)
+            sharedGrainCapture.prepare(sampleRate);
+
+        for (int i = 0; i < synth.getNumVoices(); ++i)
+        {
+            if (auto* voice = dynamic_cast<UltimatePluckVoice*>(synth.getVoice(i)))
+                voice->setSharedGrainCapture(sharedGranularCapture ? &sharedGrainCapture : nullptr);
+        }
+
+        resetGrainTelemetry();
+
+        if (! sharedGranularCapture)
+            sharedGrainCapture.release();
+
+        suspendProcessing(false);
+
+        applyVoiceRenderingMode();
+    }
+
+    UltimatePluckVoice* addPluckVoice()
+    {
+        auto* voice = new UltimatePluckVoice();
+        voice->setParameterSource(&synth.getVoiceParameters());
+        voice->setModulationLane(&synth.getVoiceModulation(), synth.getNumVoices());
+        synth.addVoice(voice);
+        return voice;
+    }
+
+    // Adds or removes voices to match the stored polyphony. New voices are
+    // prepared straight away if the processor already is.
+    void applyPolyphony()
+    {
+        const int numVoices = juce::jlimit(1, maxPolyphony, static_cast<int>(apvts->state.getProperty("polyphony", defaultPolyphony)));
+
+        if (numVoices == synth.getNumVoices())
+            return;
+
+        const double sampleRate = getSampleRate();
+        const bool isPrepared = sampleRate > 0.0;
+
+        if (isPrepared)
+            suspendProcessing(true);
+
+        while (synth.getNumVoices() > numVoices)
+            synth.removeVoice(synth.getNumVoices() - 1);
+
+        while (synth.getNumVoices() < numVoices)
+        {
+            auto* voice = addPluckVoice();
+
+            if (isPrepared)
+                voice->prepare(sampleRate, sharedGranularCapture ? &sharedGrainCapture : nullptr);
+        }
+
+        resetGrainTelemetry();
+
+        // The parallel renderer keeps one buffer per voice
+        if (isPrepared && parallelVoiceRendering)
+            synth.startParallelRendering(getNumRenderWorkers(), getBlockSize(), sampleRate);
+
+        if (isPrepared)
+            suspendProcessing(false);
+    }
+
+    // One worker per spare core, leaving one for the audio thread
+    static int getNumRenderWorkers()
+    {
+        return juce::jlimit(1, 7, juce::SystemStats::getNumCpus() - 1);
+    }
+
+    // Starts or stops the render workers if the stored mode changed. The
+    // threads are created and joined with processing suspended.
+    void applyVoiceRenderingMode()
+    {
+        const bool shouldRenderInParallel = static_cast<bool>(apvts->state.getProperty("parallelVoiceRendering", false))
+                                            && ! sharedGranularCapture;
+
+        if (shouldRenderInParallel == parallelVoiceRendering)
+            return;
+
+        parallelVoiceRendering = shouldRenderInParallel;
+
+        const double sampleRate = getSampleRate();
+
+        // Not prepared yet, prepareToPlay starts the workers
+        if (sampleRate <= 0.0)
+            return;
+
+        suspendProcessing(true);
+
+        if (parallelVoiceRendering)
+            synth.startParallelRendering(getNumRenderWorkers(), getBlockSize(), sampleRate);
+        else
+            synth.stopParallelRendering();
+
+        suspendProcessing(false);
+    }
+
+    // The factor may be automated from the audio thread, so the change is
+    // handed to the message thread
+    void parameterChanged(const juce::String&, float) override
+    {
+        triggerAsyncUpdate();
+    }
+
+    void handleAsyncUpdate() override
+    {
+        applyDistortionOversampling();
+    }
+
+    // Switches the distortion to the stored oversampling factor with
+    // processing suspended, since that clears the stage, and reports the
+    // new latency to the host
+    void applyDistortionOversampling()
+    {
+        // Not prepared yet, prepareToPlay sets the factor
+        if (getSampleRate() <= 0.0)
+            return;
+
+        const int numStages = static_cast<int>(apvts->getRawParameterValue("distortionOversampling")->load());
+
+        suspendProcessing(true);
+        advancedDistortion.setOversampling(numStages);
+        suspendProcessing(false);
+
+        setLatencySamples(advancedDistortion.getLatencyInSamples());
+    }
     std::unique_ptr<juce::AudioProcessorValueTreeState> apvts;
     std::unique_ptr<PresetManager> presetManager;
 
@@ -876,6 +2205,9 @@ private:
     std::atomic<float>* osc2MixParam = nullptr;
 
     // Effect parameters
+    std::atomic<float>* distortionDriveParam = nullptr;
+    std::atomic<float>* distortionModeParam = nullptr;
+    std::atomic<float>* distortionMixParam = nullptr;
     std::atomic<float>* delayTimeParam = nullptr;
     std::atomic<float>* delayFeedbackParam = nullptr;
     std::atomic<float>* delayMixParam = nullptr;
@@ -886,6 +2218,7 @@ private:
     std::atomic<float>* reverbWidthParam = nullptr;
     std::atomic<float>* reverbMixParam = nullptr;
     std::atomic<float>* reverbShimmerParam = nullptr;
+    std::atomic<float>* reverbModeParam = nullptr;
     std::atomic<float>* chorusRateParam = nullptr;
     std::atomic<float>* chorusDepthParam = nullptr;
     std::atomic<float>* chorusMixParam = nullptr;
@@ -983,6 +2316,18 @@ private:
             "filterEnv", "Filter Envelope", 0.0f, 1.0f, 0.5f));
         
         // EFFECTS - ALL PARAMETERS
+        // Distortion (ahead of the delay in the chain)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            "distortionDrive", "Distortion Drive", 0.0f, 1.0f, 0.0f));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            "distortionMode", "Distortion Mode",
+            juce::StringArray{"Tube", "Hard Clip", "Soft Clip", "Bitcrush", "Wavefold", "Saturate"}, 0));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            "distortionMix", "Distortion Mix", 0.0f, 1.0f, 0.0f));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            "distortionOversampling", "Distortion Oversampling",
+            juce::StringArray{"Off", "2x", "4x", "8x"}, 0));
+
         // Delay (FIRST)
         params.push_back(std::make_unique<juce::AudioParameterFloat>(
             "delayTime", "Delay Time", 1.0f, 2000.0f, 500.0f));
@@ -1008,6 +2353,9 @@ private:
             "reverbMix", "Reverb Mix", 0.0f, 1.0f, 0.3f));
         params.push_back(std::make_unique<juce::AudioParameterFloat>(
             "reverbShimmer", "Reverb Shimmer", 0.0f, 1.0f, 0.0f));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            "reverbMode", "Reverb Mode",
+            juce::StringArray{"Classic", "FDN 8", "FDN 16"}, 0));
 
         // Chorus (THIRD - replacing Distortion)
         params.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -1085,44 +2433,26 @@ private:
     void updateVoiceParameters()
     {
         // REAL-TIME SAFE - No string lookups, only cached pointer access!
+        // Continuous values come from the smoothing bank, see publishVoiceParameters()
         if (!engineModeParam || !ringsBrightnessParam || !ringsDampingParam)
             return; // Safety check
 
-        UltimatePluckVoice::VoiceParams voiceParams;
+        auto& voiceParams = blockVoiceParams;
 
         // Engine mode
         int modeIndex = engineModeParam->load();
         voiceParams.engineMode = static_cast<UltimatePluckVoice::EngineMode>(modeIndex);
 
         // Rings
-        voiceParams.ringsBrightness = ringsBrightnessParam->load();
-        voiceParams.ringsDamping = ringsDampingParam->load();
-        voiceParams.ringsPosition = ringsPositionParam->load();
-        voiceParams.ringsStructure = ringsStructureParam->load();
         int ringModelIndex = ringsModelParam->load();
         voiceParams.ringsModel = static_cast<ModalResonator::ResonatorModel>(ringModelIndex);
 
         // Clouds
-        voiceParams.cloudsParams.position = cloudsPositionParam->load();
-        voiceParams.cloudsParams.size = cloudsSizeParam->load();
-        voiceParams.cloudsParams.density = cloudsDensityParam->load();
-        voiceParams.cloudsParams.texture = cloudsTextureParam->load();
-        voiceParams.cloudsParams.pitch = cloudsPitchParam->load();
-        voiceParams.cloudsParams.stereoSpread = cloudsStereoParam->load();
         voiceParams.cloudsParams.freeze = cloudsFreezeParam->load() > 0.5f;
 
         // Wavetable
         voiceParams.wavetableParams.tableA = wavetableAParam->load();
         voiceParams.wavetableParams.tableB = wavetableBParam->load();
-        voiceParams.wavetableParams.morph = wavetableMorphParam->load();
-        voiceParams.wavetableParams.warp = wavetableWarpParam->load();
-        voiceParams.wavetableParams.fold = wavetableFoldParam->load();
-
-        // Mix
-        voiceParams.ringsMix = ringsMixParam->load();
-        voiceParams.karplusMix = karplusMixParam->load();
-        voiceParams.wavetableMix = wavetableMixParam->load();
-        voiceParams.grainsMix = grainsMixParam->load();
 
         // Envelope
         voiceParams.attack = attackParam->load();
@@ -1130,11 +2460,6 @@ private:
         voiceParams.sustain = sustainParam->load();
         voiceParams.release = releaseParam->load();
 
-        // Filter
-        voiceParams.filterCutoff = filterCutoffParam->load();
-        voiceParams.filterResonance = filterResonanceParam->load();
-        voiceParams.filterEnvAmount = filterEnvParam->load();
-
         // Basic Oscillators
         int osc1WaveIndex = osc1WaveParam->load();
         voiceParams.osc1Wave = static_cast<BasicOscillator::WaveType>(osc1WaveIndex);
@@ -1142,7 +2467,6 @@ private:
         voiceParams.osc1Semi = osc1SemiParam->load();
         voiceParams.osc1Fine = osc1FineParam->load();
         voiceParams.osc1PW = osc1PWParam->load();
-        voiceParams.osc1Mix = osc1MixParam->load();
 
         int osc2WaveIndex = osc2WaveParam->load();
         voiceParams.osc2Wave = static_cast<BasicOscillator::WaveType>(osc2WaveIndex);
@@ -1150,81 +2474,154 @@ private:
         voiceParams.osc2Semi = osc2SemiParam->load();
         voiceParams.osc2Fine = osc2FineParam->load();
         voiceParams.osc2PW = osc2PWParam->load();
-        voiceParams.osc2Mix = osc2MixParam->load();
 
-        // Update all voices
-        for (int i = 0; i < synth.getNumVoices(); ++i)
-        {
-            if (auto* voice = dynamic_cast<UltimatePluckVoice*>(synth.getVoice(i)))
-            {
-                voice->setParameters(voiceParams);
-            }
-        }
+        // Performance
+        voiceParams.portamento = portamentoParam->load();
+        voiceParams.vibratoRate = vibratoRateParam->load();
+        voiceParams.masterTune = masterTuneParam->load();
+        voiceParams.velocitySens = velocitySensParam->load();
+        voiceParams.panSpread = panSpreadParam->load();
+        voiceParams.unisonVoices = static_cast<int>(unisonVoicesParam->load());
+        voiceParams.unisonDetune = unisonDetuneParam->load();
+
+        hasVoiceParameters = true;
     }
     
-    void applyEffects(juce::AudioBuffer<float>& buffer)
+    // Runs the effect chain over one sub-block, with the smoothed values
+    // reached at its end
+    void applyEffects(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
     {
         if (buffer.getNumChannels() != 2)
             return;
 
-        int numSamples = buffer.getNumSamples();
-        auto* leftChannel = buffer.getWritePointer(0);
-        auto* rightChannel = buffer.getWritePointer(1);
+        auto* leftChannel = buffer.getWritePointer(0, startSample);
+        auto* rightChannel = buffer.getWritePointer(1, startSample);
+        const auto& bank = smoothedParameters;
 
-        // STAGE 1: DELAY - REAL-TIME SAFE (cached pointers)
+        // STAGE 1: DISTORTION - oversampled, ahead of everything that adds a tail
+        if (!distortionDriveParam || !distortionModeParam || !distortionMixParam)
+            return;
+
+        // At zero drive or mix it only delays the signal by the reported
+        // latency (none without oversampling), so engaging it doesn't shift
+        // the timing. The factor is set by applyDistortionOversampling().
+        advancedDistortion.setMode(static_cast<AdvancedDistortion::Mode>(static_cast<int>(distortionModeParam->load())));
+        advancedDistortion.setDrive(bank.get(smoothedDistortionDrive));
+        advancedDistortion.setMix(bank.get(smoothedDistortionMix));
+        advancedDistortion.processBlock(leftChannel, rightChannel, numSamples);
+
+        // STAGE 2: DELAY - REAL-TIME SAFE (cached pointers)
         if (!delayTimeParam || !delayFeedbackParam || !delayMixParam || !delayFilterParam || !delayPingPongParam)
             return;
 
-        float delayTime = this->delayTimeParam->load();
-        float delayFeedback = this->delayFeedbackParam->load();
-        float delayMix = this->delayMixParam->load();
-        float delayFilter = this->delayFilterParam->load();
+        float delayTime = bank.get(smoothedDelayTime);
+        float delayFeedback = bank.get(smoothedDelayFeedback);
+        float delayMix = bank.get(smoothedDelayMix);
+        float delayFilter = bank.get(smoothedDelayFilter);
         bool delayPingPong = this->delayPingPongParam->load() > 0.5f;
 
         if (delayMix > 0.001f)
         {
-            advancedDelay.setDelayTime(delayTime);
+            // Glides across the sub-block, so the read position never jumps
+            advancedDelay.setDelayTime(delayTime, numSamples);
             advancedDelay.setFeedback(delayFeedback);
             advancedDelay.setMix(delayMix);
             advancedDelay.setFilterCutoff(delayFilter);
             advancedDelay.setPingPong(delayPingPong);
-
-            for (int i = 0; i < numSamples; ++i)
-            {
-                leftChannel[i] = advancedDelay.processSample(leftChannel[i], 0);
-                rightChannel[i] = advancedDelay.processSample(rightChannel[i], 1);
-            }
+            advancedDelay.processBlock(leftChannel, rightChannel, numSamples);
         }
 
-        // STAGE 2: REVERB - REAL-TIME SAFE (cached pointers)
+        // STAGE 3: REVERB - REAL-TIME SAFE (cached pointers)
         if (!reverbSizeParam || !reverbDampingParam || !reverbWidthParam || !reverbMixParam || !reverbShimmerParam)
             return;
 
-        float reverbSize = this->reverbSizeParam->load();
-        float reverbDamping = this->reverbDampingParam->load();
-        float reverbWidth = this->reverbWidthParam->load();
-        float reverbMix = this->reverbMixParam->load();
-        float reverbShimmer = this->reverbShimmerParam->load();
+        float reverbSize = bank.get(smoothedReverbSize);
+        float reverbDamping = bank.get(smoothedReverbDamping);
+        float reverbWidth = bank.get(smoothedReverbWidth);
+        float reverbMix = bank.get(smoothedReverbMix);
+        float reverbShimmer = bank.get(smoothedReverbShimmer);
+
+        // 0 = Classic (EnhancedReverb), 1 = FDN 8 lines, 2 = FDN 16 lines
+        const int reverbMode = reverbModeParam != nullptr ? juce::jlimit(0, numReverbModes - 1, static_cast<int>(reverbModeParam->load())) : 0;
+
+        // Runs one engine with the current settings: 0 = Classic, 1 = FDN 8 lines, 2 = FDN 16 lines
+        auto processReverb = [&](int mode, float* left, float* right)
+        {
+            if (mode == 0)
+            {
+                enhancedReverb.setSize(reverbSize);
+                enhancedReverb.setDamping(reverbDamping);
+                enhancedReverb.setWidth(reverbWidth);
+                enhancedReverb.setMix(reverbMix);
+                enhancedReverb.setShimmer(reverbShimmer);
+                enhancedReverb.setTrueStereo(trueStereoReverb.load(std::memory_order_relaxed));
+                enhancedReverb.processStereo(left, right, numSamples);
+            }
+            else
+            {
+                auto& fdnReverb = fdnReverbs[(size_t) mode - 1];
+                fdnReverb.setSize(reverbSize);
+                fdnReverb.setDamping(reverbDamping);
+                fdnReverb.setWidth(reverbWidth);
+                fdnReverb.setMix(reverbMix);
+                fdnReverb.setShimmer(reverbShimmer);
+                fdnReverb.processStereo(left, right, numSamples);
+            }
+        };
+
+        if (reverbMode != lastReverbMode)
+        {
+            // The outgoing engine rings out. The incoming one picks up its
+            // own tail if that is still ringing, and otherwise starts from
+            // silence rather than a stale tail.
+            if (! reverbRingingOut[(size_t) reverbMode])
+            {
+                if (reverbMode == 0)
+                    enhancedReverb.reset();
+                else
+                    fdnReverbs[(size_t) reverbMode - 1].reset();
+            }
+
+            reverbRingingOut[(size_t) reverbMode] = false;
+            reverbRingingOut[(size_t) lastReverbMode] = true;
+            lastReverbMode = reverbMode;
+        }
 
         if (reverbMix > 0.001f)
         {
-            enhancedReverb.setSize(reverbSize);
-            enhancedReverb.setDamping(reverbDamping);
-            enhancedReverb.setWidth(reverbWidth);
-            enhancedReverb.setMix(reverbMix);
-            enhancedReverb.setShimmer(reverbShimmer);
-            enhancedReverb.processStereo(leftChannel, rightChannel, numSamples);
+            processReverb(reverbMode, leftChannel, rightChannel);
+
+            for (int mode = 0; mode < numReverbModes; ++mode)
+            {
+                if (! reverbRingingOut[(size_t) mode])
+                    continue;
+
+                // Silent input, so the engine's output is only its wet tail
+                std::array<float, maxSubBlockSize> tailL {}, tailR {};
+                jassert(numSamples <= maxSubBlockSize);
+                processReverb(mode, tailL.data(), tailR.data());
+
+                juce::FloatVectorOperations::add(leftChannel, tailL.data(), numSamples);
+                juce::FloatVectorOperations::add(rightChannel, tailR.data(), numSamples);
+
+                const auto rangeL = juce::FloatVectorOperations::findMinAndMax(tailL.data(), numSamples);
+                const auto rangeR = juce::FloatVectorOperations::findMinAndMax(tailR.data(), numSamples);
+                const float peak = juce::jmax(-rangeL.getStart(), rangeL.getEnd(), -rangeR.getStart(), rangeR.getEnd());
+
+                if (peak < reverbTailThreshold)
+                    reverbRingingOut[(size_t) mode] = false;
+            }
         }
 
-        // STAGE 3: CHORUS - REAL-TIME SAFE (cached pointers)
+        // STAGE 4: CHORUS - REAL-TIME SAFE (cached pointers)
         if (!chorusRateParam || !chorusDepthParam || !chorusMixParam || !chorusFeedbackParam || !chorusWidthParam)
             return;
 
-        float chorusRate = this->chorusRateParam->load();
-        float chorusDepth = this->chorusDepthParam->load();
-        float chorusMix = this->chorusMixParam->load();
-        float chorusFeedback = this->chorusFeedbackParam->load();
-        float chorusWidth = this->chorusWidthParam->load();
+        float chorusRate = bank.get(smoothedChorusRate);
+        float chorusDepth = bank.get(smoothedChorusDepth);
+        float chorusMix = bank.get(smoothedChorusMix);
+        float chorusFeedback = bank.get(smoothedChorusFeedback);
+        float chorusWidth = bank.get(smoothedChorusWidth);
 
         if (chorusMix > 0.001f)
         {
@@ -1233,11 +2630,7 @@ private:
             chorus.setMix(chorusMix);
             chorus.setFeedback(chorusFeedback);
             chorus.setStereoWidth(chorusWidth);
-
-            for (int i = 0; i < numSamples; ++i)
-            {
-                chorus.processStereo(leftChannel[i], rightChannel[i]);
-            }
+            chorus.processBlock(leftChannel, rightChannel, numSamples);
         }
 
         // FINAL STAGE: Gentler soft limiter to prevent distortion
@@ -129,10 +129,11 @@ public:
         resized();
     }
     
-    // Forward grain spawning to visualizer
-    void spawnGrain(float position, float amplitude, float pitch, float size)
+    // Forward grain spawning to visualizer; count is how many grains the
+    // description stands for
+    void spawnGrain(float position, float amplitude, float pitch, float size, int count = 1)
     {
-        grainVisualizer->spawnGrain(position, amplitude, pitch, size);
+        grainVisualizer->spawnGrainBurst(count, position, amplitude, pitch, size);
     }
     
     void updateGrainParameters(float density, float grainSize, float position, float texture)